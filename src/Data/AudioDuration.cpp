@@ -0,0 +1,162 @@
+#include "AudioDuration.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <SFML/Audio/InputSoundFile.hpp>
+
+namespace Data {
+
+    namespace {
+        // All the formats we look at store their numbers in little endian, except FLAC
+        std::uint64_t read_le(const unsigned char* bytes, std::size_t count) {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                value |= static_cast<std::uint64_t>(bytes[i]) << (8*i);
+            }
+            return value;
+        }
+
+        std::uint64_t read_be(const unsigned char* bytes, std::size_t count) {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                value = (value << 8) | bytes[i];
+            }
+            return value;
+        }
+
+        bool read_exactly(std::istream& file, unsigned char* buffer, std::size_t count) {
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(count)));
+        }
+
+        sf::Time samples_to_time(std::uint64_t samples, std::uint64_t sample_rate) {
+            return sf::microseconds(static_cast<sf::Int64>((samples * 1000000) / sample_rate));
+        }
+
+        // RIFF WAVE : walk the chunks until we know both the block size and the size of the data chunk
+        std::optional<sf::Time> probe_wav(std::istream& file) {
+            unsigned char header[12];
+            if (not read_exactly(file, header, 12) or std::memcmp(header+8, "WAVE", 4) != 0) {
+                return {};
+            }
+            std::uint64_t sample_rate = 0;
+            std::uint64_t block_align = 0;
+            unsigned char chunk_header[8];
+            while (read_exactly(file, chunk_header, 8)) {
+                auto chunk_size = read_le(chunk_header+4, 4);
+                if (std::memcmp(chunk_header, "fmt ", 4) == 0) {
+                    unsigned char fmt[16];
+                    if (chunk_size < 16 or not read_exactly(file, fmt, 16)) {
+                        return {};
+                    }
+                    sample_rate = read_le(fmt+4, 4);
+                    block_align = read_le(fmt+12, 2);
+                    chunk_size -= 16;
+                } else if (std::memcmp(chunk_header, "data", 4) == 0) {
+                    if (sample_rate == 0 or block_align == 0) {
+                        return {};
+                    }
+                    return samples_to_time(chunk_size / block_align, sample_rate);
+                }
+                // chunks are padded to an even size
+                file.seekg(static_cast<std::streamoff>(chunk_size + (chunk_size % 2)), std::ios::cur);
+            }
+            return {};
+        }
+
+        // FLAC : the STREAMINFO block is always the first one and holds the total sample count
+        std::optional<sf::Time> probe_flac(std::istream& file) {
+            unsigned char header[4+4+34];
+            if (not read_exactly(file, header, sizeof(header))) {
+                return {};
+            }
+            const unsigned char* streaminfo = header+8;
+            if ((header[4] & 0x7F) != 0) {
+                return {};
+            }
+            // 20 bits of sample rate, 3 bits of channels, 5 bits of bits per sample, 36 bits of total samples
+            auto packed = read_be(streaminfo+10, 8);
+            auto sample_rate = packed >> 44;
+            auto total_samples = packed & 0xFFFFFFFFFULL;
+            // zero means unknown
+            if (sample_rate == 0 or total_samples == 0) {
+                return {};
+            }
+            return samples_to_time(total_samples, sample_rate);
+        }
+
+        // Ogg Vorbis : the sample rate is in the identification header at the very start,
+        // and the granule position of the last page is the total sample count
+        std::optional<sf::Time> probe_ogg(std::istream& file, std::uint64_t file_size) {
+            // page header is 27 bytes + the segment table, the identification header follows
+            unsigned char first_page[27];
+            if (not read_exactly(file, first_page, 27)) {
+                return {};
+            }
+            file.seekg(first_page[26], std::ios::cur);
+            unsigned char identification[16];
+            if (not read_exactly(file, identification, 16) or std::memcmp(identification, "\x01vorbis", 7) != 0) {
+                return {};
+            }
+            auto sample_rate = read_le(identification+12, 4);
+            if (sample_rate == 0) {
+                return {};
+            }
+            // An ogg page is at most ~64KiB, so the last page header is somewhere in the last 64KiB
+            const std::uint64_t tail_size = std::min<std::uint64_t>(file_size, 65536 + 27);
+            std::vector<unsigned char> tail(tail_size);
+            file.seekg(static_cast<std::streamoff>(file_size - tail_size), std::ios::beg);
+            if (not read_exactly(file, tail.data(), tail.size())) {
+                return {};
+            }
+            if (tail.size() < 27) {
+                return {};
+            }
+            for (auto i = tail.size() - 27 + 1; i-- > 0;) {
+                if (std::memcmp(tail.data()+i, "OggS", 4) == 0) {
+                    auto granule = read_le(tail.data()+i+6, 8);
+                    // -1 means no packet ends on this page
+                    if (granule == 0xFFFFFFFFFFFFFFFFULL) {
+                        continue;
+                    }
+                    return samples_to_time(granule, sample_rate);
+                }
+            }
+            return {};
+        }
+    }
+
+    std::optional<sf::Time> probe_audio_duration(const fs::path& path) {
+        std::error_code ec;
+        auto file_size = fs::file_size(path, ec);
+        if (ec) {
+            return {};
+        }
+        std::optional<sf::Time> duration;
+        {
+            std::ifstream file{path, std::ios::binary};
+            unsigned char magic[4];
+            if (file and read_exactly(file, magic, 4)) {
+                file.seekg(0);
+                if (std::memcmp(magic, "RIFF", 4) == 0) {
+                    duration = probe_wav(file);
+                } else if (std::memcmp(magic, "fLaC", 4) == 0) {
+                    duration = probe_flac(file);
+                } else if (std::memcmp(magic, "OggS", 4) == 0) {
+                    duration = probe_ogg(file, file_size);
+                }
+            }
+        }
+        if (duration) {
+            return duration;
+        }
+        sf::InputSoundFile sound_file;
+        if (sound_file.openFromFile(path.string())) {
+            return sound_file.getDuration();
+        }
+        return {};
+    }
+}
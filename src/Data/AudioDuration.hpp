@@ -0,0 +1,17 @@
+#pragma once
+
+#include <optional>
+
+#include <ghc/filesystem.hpp>
+#include <SFML/System/Time.hpp>
+
+namespace fs = ghc::filesystem;
+
+namespace Data {
+    // Finds out how long an audio file is by only reading the few bytes that tell,
+    // which is way cheaper than opening a whole sf::Music.
+    // WAV, FLAC and Ogg Vorbis headers are read directly,
+    // anything else falls back to opening the file with sf::InputSoundFile.
+    // Returns empty if the file can't be read
+    std::optional<sf::Time> probe_audio_duration(const fs::path& path);
+}
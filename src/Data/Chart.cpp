@@ -1,6 +1,8 @@
 #include "Chart.hpp"
 
+#include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 #include "../Toolkit/AffineTransform.hpp"
 
@@ -21,6 +23,8 @@ namespace Data {
             0.f, static_cast<float>(chart.resolution),
             0.f, (60.f/memon.BPM)
         );
+        std::vector<Note> chart_notes;
+        chart_notes.reserve(chart.notes.size());
         for (auto &&note : chart.notes) {
             auto timing = sf::seconds(memon_timing_to_seconds.transform(note.get_timing()));
             auto position = static_cast<Input::Button>(note.get_pos());
@@ -30,8 +34,16 @@ namespace Data {
                 length = sf::seconds(memon_timing_to_seconds_proportional.transform(note.get_length()));
                 tail = convert_memon_tail(position, note.get_tail_pos());
             }
-            notes.insert({timing, position, length, tail});
+            chart_notes.push_back({timing, position, length, tail});
         }
+        notes = NoteStore{std::move(chart_notes)};
+    }
+
+    Chart::Chart(int t_level, std::vector<Note> t_notes, std::size_t t_resolution) :
+        level(t_level),
+        notes(std::move(t_notes)),
+        resolution(t_resolution)
+    {
     }
 
     Input::Button convert_memon_tail(Input::Button note, unsigned int tail_position) {
@@ -84,18 +96,16 @@ namespace Data {
     TimeBounds Data::Chart::get_time_bounds_from_notes() const {
         if (notes.empty()) {
             return TimeBounds{};
-        } else {
-            const auto& first_note = *notes.begin();
-            const auto& last_note = *std::max_element(
-                notes.begin(),
-                notes.end(),
-                [](const Data::Note& a, const Data::Note& b) -> bool {
-                    return a.timing+a.duration < b.timing+b.duration;
-                }
-            );
-            auto first_timing_point = sf::microseconds(std::min(0LL, first_note.timing.asMicroseconds()));
-            auto last_timing_point = last_note.timing+last_note.duration;       
-            return {first_timing_point, last_timing_point}; 
         }
+        const auto& timings = notes.get_timings();
+        const auto& durations = notes.get_durations();
+        auto last_timing_point = timings[0] + durations[0];
+        for (std::size_t i = 1; i < timings.size(); i++) {
+            last_timing_point = std::max(last_timing_point, timings[i] + durations[i]);
+        }
+        return {
+            sf::microseconds(std::min<sf::Int64>(0, timings.front())),
+            sf::microseconds(last_timing_point)
+        };
     }
 }
@@ -1,20 +1,22 @@
 #pragma once
 
 #include <cstddef>
-#include <set>
+#include <vector>
 
 #include <memon/memon.hpp>
 #include <SFML/System/Time.hpp>
 
 #include "../Input/Buttons.hpp"
 #include "Note.hpp"
+#include "NoteStore.hpp"
 #include "TimeBounds.hpp"
 
 namespace Data {
     struct Chart {
         Chart(const stepland::memon& memon, const std::string& difficulty);
+        Chart(int t_level, std::vector<Note> t_notes, std::size_t t_resolution);
         int level;
-        std::set<Note> notes;
+        NoteStore notes;
         std::size_t resolution;
         // get the time at which the very last scorable event happens
         // (i.e. note tap or long note release)
@@ -0,0 +1,117 @@
+#include "CompiledChart.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../Toolkit/BinaryIO.hpp"
+#include "../Toolkit/FNV1a.hpp"
+#include "../Toolkit/MappedFile.hpp"
+
+namespace Data {
+
+    namespace {
+        constexpr std::uint64_t compiled_chart_magic = Toolkit::fnv1a_64("jujube compiled chart");
+        // Bump this whenever the layout of the file changes
+        constexpr std::uint32_t compiled_chart_version = 1;
+
+        Input::Button read_button(const char*& cursor, const char* end) {
+            auto index = Toolkit::read_binary<std::uint8_t>(cursor, end);
+            auto button = Input::index_to_button(index);
+            if (not button) {
+                throw std::runtime_error("Invalid button index : "+std::to_string(index));
+            }
+            return *button;
+        }
+    }
+
+    fs::path compiled_chart_path(const fs::path& compiled_charts_folder, const fs::path& memon_path, const std::string& difficulty) {
+        auto hash = Toolkit::fnv1a_64(memon_path.string());
+        hash = Toolkit::fnv1a_64(std::string(1, '\0'), hash);
+        hash = Toolkit::fnv1a_64(difficulty, hash);
+        std::ostringstream name;
+        name << std::hex << hash << ".bin";
+        return compiled_charts_folder/name.str();
+    }
+
+    std::optional<Chart> load_compiled_chart(const fs::path& path, const FileStamp& memon_stamp) {
+        if (not fs::exists(path)) {
+            return {};
+        }
+        try {
+            Toolkit::MappedFile file{path};
+            const char* cursor = file.data();
+            const char* end = file.data() + file.size();
+            if (Toolkit::read_binary<std::uint64_t>(cursor, end) != compiled_chart_magic) {
+                throw std::runtime_error("not a compiled chart");
+            }
+            if (Toolkit::read_binary<std::uint32_t>(cursor, end) != compiled_chart_version) {
+                return {};
+            }
+            FileStamp stamp;
+            stamp.mtime = Toolkit::read_binary<std::int64_t>(cursor, end);
+            stamp.size = Toolkit::read_binary<std::uint64_t>(cursor, end);
+            if (stamp != memon_stamp) {
+                return {};
+            }
+            auto level = Toolkit::read_binary<std::int32_t>(cursor, end);
+            auto resolution = Toolkit::read_binary<std::uint64_t>(cursor, end);
+            auto note_count = Toolkit::read_binary<std::uint64_t>(cursor, end);
+            std::vector<Note> notes;
+            // each record is 18 bytes, don't trust a corrupted note count for the reservation
+            notes.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(note_count, static_cast<std::uint64_t>(end - cursor) / 18)));
+            for (std::uint64_t i = 0; i < note_count; i++) {
+                Note note;
+                note.timing = sf::microseconds(Toolkit::read_binary<std::int64_t>(cursor, end));
+                note.duration = sf::microseconds(Toolkit::read_binary<std::int64_t>(cursor, end));
+                note.position = read_button(cursor, end);
+                note.tail = read_button(cursor, end);
+                notes.push_back(note);
+            }
+            return Chart{level, std::move(notes), static_cast<std::size_t>(resolution)};
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring compiled chart " << path << " : " << e.what() << '\n';
+            return {};
+        }
+    }
+
+    void save_compiled_chart(const fs::path& path, const Chart& chart, const FileStamp& memon_stamp) {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        if (ec) {
+            std::cerr << "Can't create folder " << path.parent_path() << " to save compiled charts : " << ec.message() << '\n';
+            return;
+        }
+        // Write to a temporary file first so a crash never leaves a half-written chart behind
+        auto temp_path = path;
+        temp_path += ".tmp";
+        {
+            std::ofstream file{temp_path, std::ios::binary | std::ios::trunc};
+            Toolkit::write_binary<std::uint64_t>(file, compiled_chart_magic);
+            Toolkit::write_binary<std::uint32_t>(file, compiled_chart_version);
+            Toolkit::write_binary<std::int64_t>(file, memon_stamp.mtime);
+            Toolkit::write_binary<std::uint64_t>(file, memon_stamp.size);
+            Toolkit::write_binary<std::int32_t>(file, chart.level);
+            Toolkit::write_binary<std::uint64_t>(file, chart.resolution);
+            Toolkit::write_binary<std::uint64_t>(file, chart.notes.size());
+            for (std::size_t i = 0; i < chart.notes.size(); i++) {
+                Toolkit::write_binary<std::int64_t>(file, chart.notes.get_timings()[i]);
+                Toolkit::write_binary<std::int64_t>(file, chart.notes.get_durations()[i]);
+                Toolkit::write_binary<std::uint8_t>(file, static_cast<std::uint8_t>(Input::button_to_index(chart.notes.position(i))));
+                Toolkit::write_binary<std::uint8_t>(file, static_cast<std::uint8_t>(Input::button_to_index(chart.notes.tail(i))));
+            }
+            if (not file) {
+                std::cerr << "Error while saving compiled chart " << path << '\n';
+                return;
+            }
+        }
+        fs::rename(temp_path, path, ec);
+        if (ec) {
+            std::cerr << "Error while saving compiled chart " << path << " : " << ec.message() << '\n';
+        }
+    }
+}
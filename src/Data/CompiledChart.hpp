@@ -0,0 +1,32 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <ghc/filesystem.hpp>
+
+#include "Chart.hpp"
+#include "SongIndex.hpp"
+
+namespace fs = ghc::filesystem;
+
+namespace Data {
+
+    // Compiled charts are binary dumps of a Data::Chart, with timings already converted to microseconds.
+    // They are cached in data/charts/ so loading a chart does not need to go through the json parser
+    // and the memon timing conversion
+    //
+    // Layout (native byte order) :
+    //   header : magic, format version, FileStamp of the source .memon, level, resolution, note count
+    //   notes  : note count fixed-size records sorted by timing then position
+
+    // Where the compiled version of this chart is cached
+    fs::path compiled_chart_path(const fs::path& compiled_charts_folder, const fs::path& memon_path, const std::string& difficulty);
+
+    // Returns empty if the file does not exist, is from another format version,
+    // or was compiled from a different version of the .memon file
+    std::optional<Chart> load_compiled_chart(const fs::path& path, const FileStamp& memon_stamp);
+
+    // Errors are reported on std::cerr and otherwise ignored, the cache is just an optimisation
+    void save_compiled_chart(const fs::path& path, const Chart& chart, const FileStamp& memon_stamp);
+}
@@ -0,0 +1,179 @@
+#include "MemonMetadata.hpp"
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+namespace Data {
+
+    namespace {
+        // SAX handler that builds the json document like nlohmann's own DOM parser would,
+        // except the "notes" array of each chart is replaced by an empty array.
+        // This avoids allocating a json value for every note of every chart
+        class NotelessSax {
+        public:
+            using json = nlohmann::json;
+
+            explicit NotelessSax(json& result) : dom_parser(result) {};
+
+            bool null() {
+                return skipping() or dom_parser.null();
+            };
+            bool boolean(bool val) {
+                return skipping() or dom_parser.boolean(val);
+            };
+            bool number_integer(json::number_integer_t val) {
+                return skipping() or dom_parser.number_integer(val);
+            };
+            bool number_unsigned(json::number_unsigned_t val) {
+                return skipping() or dom_parser.number_unsigned(val);
+            };
+            bool number_float(json::number_float_t val, const json::string_t& s) {
+                return skipping() or dom_parser.number_float(val, s);
+            };
+            bool string(json::string_t& val) {
+                return skipping() or dom_parser.string(val);
+            };
+            bool key(json::string_t& val) {
+                if (skip_depth > 0) {
+                    return true;
+                }
+                // charts live at depth 3 : root object > "data" > chart
+                // whether "data" is an object (v0.1.0 and up) or an array (fallback)
+                next_array_is_notes = (depth == 3 and val == "notes");
+                return dom_parser.key(val);
+            };
+            bool start_object(std::size_t elements) {
+                if (skip_depth > 0) {
+                    skip_depth++;
+                    return true;
+                }
+                next_array_is_notes = false;
+                depth++;
+                return dom_parser.start_object(elements);
+            };
+            bool end_object() {
+                if (skip_depth > 0) {
+                    skip_depth--;
+                    return true;
+                }
+                depth--;
+                return dom_parser.end_object();
+            };
+            bool start_array(std::size_t elements) {
+                if (skip_depth > 0) {
+                    skip_depth++;
+                    return true;
+                }
+                if (next_array_is_notes) {
+                    next_array_is_notes = false;
+                    skip_depth = 1;
+                    return dom_parser.start_array(0);
+                }
+                depth++;
+                return dom_parser.start_array(elements);
+            };
+            bool end_array() {
+                if (skip_depth > 0) {
+                    skip_depth--;
+                    // closing the notes array itself
+                    return skip_depth > 0 or dom_parser.end_array();
+                }
+                depth--;
+                return dom_parser.end_array();
+            };
+            bool parse_error(std::size_t position, const std::string& last_token, const nlohmann::detail::exception& ex) {
+                return dom_parser.parse_error(position, last_token, ex);
+            };
+        private:
+            bool skipping() {
+                next_array_is_notes = false;
+                return skip_depth > 0;
+            };
+
+            nlohmann::detail::json_sax_dom_parser<json> dom_parser;
+            std::size_t depth = 0;
+            std::size_t skip_depth = 0;
+            bool next_array_is_notes = false;
+        };
+
+        const nlohmann::json& get_metadata_object(const nlohmann::json& memon_json) {
+            const auto& metadata = memon_json.at("metadata");
+            if (not metadata.is_object()) {
+                throw std::invalid_argument("metadata fields is not an object");
+            }
+            return metadata;
+        }
+
+        // Mirrors what stepland::memon expects from v0.1.0 and v0.2.0 files
+        MemonMetadata read_versioned(const nlohmann::json& memon_json, bool has_preview) {
+            MemonMetadata res;
+            const auto& metadata = get_metadata_object(memon_json);
+            res.song_title = metadata.at("song title").get<std::string>();
+            res.artist = metadata.at("artist").get<std::string>();
+            res.music_path = metadata.at("music path").get<std::string>();
+            res.album_cover_path = metadata.at("album cover path").get<std::string>();
+            // "preview" is optional in v0.2.0, it missing is NOT an error
+            if (has_preview and metadata.find("preview") != metadata.end()) {
+                const auto& preview_json = metadata.at("preview");
+                res.preview.emplace(
+                    sf::seconds(preview_json.at("position").get<float>()),
+                    sf::seconds(preview_json.at("duration").get<float>())
+                );
+            }
+            if (not memon_json.at("data").is_object()) {
+                throw std::invalid_argument("data field is not an object");
+            }
+            for (const auto& [dif_name, chart_json] : memon_json.at("data").items()) {
+                res.chart_levels[dif_name] = chart_json.at("level").get<int>();
+            }
+            return res;
+        }
+
+        // Old, unversionned schema, see stepland::memon::load_from_memon_fallback
+        MemonMetadata read_fallback(const nlohmann::json& memon_json) {
+            MemonMetadata res;
+            const auto& metadata = get_metadata_object(memon_json);
+            res.song_title = metadata.at("song title").get<std::string>();
+            res.artist = metadata.at("artist").get<std::string>();
+            res.music_path = metadata.at("music path").get<std::string>();
+            res.album_cover_path = metadata.at("jacket path").get<std::string>();
+            if (not memon_json.at("data").is_array()) {
+                throw std::invalid_argument("data field is not an array");
+            }
+            for (const auto& chart_json : memon_json.at("data")) {
+                auto dif_name = chart_json.at("dif_name").get<std::string>();
+                if (res.chart_levels.find(dif_name) != res.chart_levels.end()) {
+                    throw std::invalid_argument("duplicate chart name in memon : "+dif_name);
+                }
+                res.chart_levels[dif_name] = chart_json.value("level", 0);
+            }
+            return res;
+        }
+    }
+
+    MemonMetadata read_memon_metadata(const fs::path& memon_path) {
+        nlohmann::json memon_json;
+        {
+            std::ifstream file(memon_path);
+            NotelessSax sax{memon_json};
+            nlohmann::json::sax_parse(file, &sax);
+        }
+        if (memon_json.find("version") == memon_json.end()) {
+            return read_fallback(memon_json);
+        }
+        if (not memon_json.at("version").is_string()) {
+            throw std::invalid_argument("Unexpected version field : "+memon_json.at("version").dump());
+        }
+        auto version = memon_json.at("version").get<std::string>();
+        if (version == "0.1.0") {
+            return read_versioned(memon_json, false);
+        } else if (version == "0.2.0") {
+            return read_versioned(memon_json, true);
+        } else {
+            throw std::invalid_argument("Unsupported .memon version : "+version);
+        }
+    }
+}
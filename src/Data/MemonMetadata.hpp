@@ -0,0 +1,29 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+
+#include <ghc/filesystem.hpp>
+#include <SFML/Audio.hpp>
+
+namespace fs = ghc::filesystem;
+
+namespace Data {
+
+    // Everything the song scan needs from a .memon file
+    struct MemonMetadata {
+        std::string song_title;
+        std::string artist;
+        std::string music_path;
+        std::string album_cover_path;
+        std::optional<sf::Music::TimeSpan> preview;
+        // Mapping from chart difficulty to the numeric level
+        std::map<std::string, int> chart_levels;
+    };
+
+    // Streams through the file and only keeps the metadata and chart levels,
+    // note arrays are skipped without ever being stored.
+    // Notes are NOT validated, this is left to the full parse done when a chart is actually loaded
+    MemonMetadata read_memon_metadata(const fs::path& memon_path);
+}
@@ -0,0 +1,43 @@
+#include "NoteStore.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace Data {
+    NoteStore::NoteStore(std::vector<Note> notes) {
+        // compiled charts are already sorted, stable so the first of two duplicates is kept
+        if (not std::is_sorted(notes.begin(), notes.end())) {
+            std::stable_sort(notes.begin(), notes.end());
+        }
+        notes.erase(std::unique(notes.begin(), notes.end()), notes.end());
+        timings_us.reserve(notes.size());
+        durations_us.reserve(notes.size());
+        positions.reserve(notes.size());
+        tails.reserve(notes.size());
+        for (std::size_t i = 0; i < notes.size(); i++) {
+            const auto& note = notes[i];
+            auto position = Input::button_to_index(note.position);
+            timings_us.push_back(note.timing.asMicroseconds());
+            durations_us.push_back(note.duration.asMicroseconds());
+            positions.push_back(static_cast<std::uint8_t>(position));
+            tails.push_back(static_cast<std::uint8_t>(Input::button_to_index(note.tail)));
+            button_indices.at(position).push_back(static_cast<std::uint32_t>(i));
+            if (note.duration > sf::Time::Zero) {
+                long_notes++;
+            }
+        }
+    }
+
+    Note NoteStore::operator[](std::size_t index) const {
+        return {timing(index), position(index), duration(index), tail(index)};
+    }
+
+    const std::vector<std::uint32_t>& NoteStore::notes_on(Input::Button button) const {
+        return button_indices.at(Input::button_to_index(button));
+    }
+
+    std::size_t NoteStore::upper_bound(sf::Time time) const {
+        auto it = std::upper_bound(timings_us.begin(), timings_us.end(), time.asMicroseconds());
+        return static_cast<std::size_t>(it - timings_us.begin());
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <SFML/System/Time.hpp>
+
+#include "../Input/Buttons.hpp"
+#include "Note.hpp"
+
+namespace Data {
+    // The notes of a chart, sorted by timing then position.
+    // Each field lives in its own contiguous array so that scanning through
+    // timings or durations only touches the memory it needs
+    class NoteStore {
+    public:
+        // Iterates over the notes as Data::Note values built on the fly
+        class const_iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Note;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Note;
+
+            const_iterator(const NoteStore& t_store, std::size_t t_index) : store(&t_store), index(t_index) {};
+            Note operator*() const {return (*store)[index];};
+            const_iterator& operator++() {index++; return *this;};
+            const_iterator operator++(int) {auto copy = *this; index++; return copy;};
+            bool operator==(const const_iterator& rhs) const {return index == rhs.index;};
+            bool operator!=(const const_iterator& rhs) const {return index != rhs.index;};
+        private:
+            const NoteStore* store;
+            std::size_t index;
+        };
+
+        NoteStore() = default;
+        // The notes don't need to be sorted, duplicates (same timing and position) are dropped
+        explicit NoteStore(std::vector<Note> notes);
+
+        std::size_t size() const {return timings_us.size();};
+        bool empty() const {return timings_us.empty();};
+        Note operator[](std::size_t index) const;
+        const_iterator begin() const {return {*this, 0};};
+        const_iterator end() const {return {*this, size()};};
+
+        sf::Time timing(std::size_t index) const {return sf::microseconds(timings_us[index]);};
+        sf::Time duration(std::size_t index) const {return sf::microseconds(durations_us[index]);};
+        Input::Button position(std::size_t index) const {return static_cast<Input::Button>(positions[index]);};
+        Input::Button tail(std::size_t index) const {return static_cast<Input::Button>(tails[index]);};
+
+        // Raw arrays, timings and durations are in microseconds
+        const std::vector<sf::Int64>& get_timings() const {return timings_us;};
+        const std::vector<sf::Int64>& get_durations() const {return durations_us;};
+
+        // Indices of the notes on the given button, in timing order
+        const std::vector<std::uint32_t>& notes_on(Input::Button button) const;
+        // Index of the first note with a timing strictly greater than the given time
+        std::size_t upper_bound(sf::Time time) const;
+        std::size_t long_note_count() const {return long_notes;};
+    private:
+        std::vector<sf::Int64> timings_us;
+        std::vector<sf::Int64> durations_us;
+        std::vector<std::uint8_t> positions;
+        std::vector<std::uint8_t> tails;
+        std::array<std::vector<std::uint32_t>, 16> button_indices;
+        std::size_t long_notes = 0;
+    };
+}
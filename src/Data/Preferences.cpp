@@ -55,7 +55,9 @@ namespace Data {
         j = nlohmann::json{
             {"marker", o.marker},
             {"ln_marker", o.ln_marker},
-            {"audio_offset", o.audio_offset.asMilliseconds()}
+            {"audio_offset", o.audio_offset.asMilliseconds()},
+            {"evdev_input", o.evdev_input},
+            {"max_decoded_music_mb", o.max_decoded_music_mb}
         };
     }
 
@@ -63,6 +65,8 @@ namespace Data {
         j.at("marker").get_to(o.marker);
         j.at("ln_marker").get_to(o.ln_marker);
         o.audio_offset = sf::milliseconds(j.at("audio_offset").get<sf::Int32>());
+        o.evdev_input = j.value("evdev_input", false);
+        o.max_decoded_music_mb = j.value("max_decoded_music_mb", std::size_t{256});
     }    
     
     // RAII style class which loads preferences from the dedicated file when constructed and saves them when destructed
@@ -63,6 +63,11 @@ namespace Data {
         std::string marker;
         std::string ln_marker;
         sf::Time audio_offset;
+        // Read keyboards through evdev during gameplay for precise timestamps (Linux only)
+        bool evdev_input = false;
+        // Songs whose decoded audio would take more than this are streamed from disk
+        // during gameplay instead of being decoded in memory, 0 means always stream
+        std::size_t max_decoded_music_mb = 256;
     };
 
     void to_json(nlohmann::json& j, const Options& o);
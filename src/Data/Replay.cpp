@@ -0,0 +1,96 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "../Toolkit/BinaryIO.hpp"
+#include "../Toolkit/FNV1a.hpp"
+#include "../Toolkit/MappedFile.hpp"
+
+namespace Data {
+    namespace {
+        constexpr std::uint64_t replay_magic = Toolkit::fnv1a_64("jujube replay");
+        // Bump this whenever the layout of the file changes
+        constexpr std::uint32_t replay_version = 1;
+
+        template<typename T>
+        std::uint64_t hash_value(const T& value, std::uint64_t hash) {
+            return Toolkit::fnv1a_64({reinterpret_cast<const char*>(&value), sizeof(T)}, hash);
+        }
+    }
+
+    void Replay::save(const fs::path& path) const {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        std::ofstream file{path, std::ios::binary};
+        if (not file) {
+            throw std::runtime_error("Could not open "+path.string()+" for writing");
+        }
+        Toolkit::write_binary<std::uint64_t>(file, replay_magic);
+        Toolkit::write_binary<std::uint32_t>(file, replay_version);
+        Toolkit::write_binary<std::uint64_t>(file, chart_hash);
+        Toolkit::write_signed_varint(file, audio_offset.asMicroseconds());
+        Toolkit::write_binary_string(file, song_folder.string());
+        Toolkit::write_binary_string(file, difficulty);
+        Toolkit::write_varint(file, events.size());
+        sf::Time previous = sf::Time::Zero;
+        for (const auto& [time, event] : events) {
+            // evdev events can be judged slightly out of order, hence the signed deltas
+            Toolkit::write_signed_varint(file, (time - previous).asMicroseconds());
+            auto released = event.type == Input::EventType::Released ? 1 : 0;
+            Toolkit::write_binary<std::uint8_t>(file, static_cast<std::uint8_t>(Input::button_to_index(event.button) << 1 | released));
+            previous = time;
+        }
+        if (not file) {
+            throw std::runtime_error("Could not write "+path.string());
+        }
+    }
+
+    Replay Replay::load(const fs::path& path) {
+        Toolkit::MappedFile file{path};
+        const char* cursor = file.data();
+        const char* end = file.data() + file.size();
+        if (Toolkit::read_binary<std::uint64_t>(cursor, end) != replay_magic) {
+            throw std::runtime_error(path.string()+" is not a replay");
+        }
+        auto version = Toolkit::read_binary<std::uint32_t>(cursor, end);
+        if (version != replay_version) {
+            throw std::runtime_error("Unsupported replay version : "+std::to_string(version));
+        }
+        Replay replay;
+        replay.chart_hash = Toolkit::read_binary<std::uint64_t>(cursor, end);
+        replay.audio_offset = sf::microseconds(Toolkit::read_signed_varint(cursor, end));
+        replay.song_folder = Toolkit::read_binary_string(cursor, end);
+        replay.difficulty = Toolkit::read_binary_string(cursor, end);
+        auto event_count = Toolkit::read_varint(cursor, end);
+        // each event takes at least 2 bytes, don't trust a corrupted count for the reservation
+        replay.events.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(event_count, static_cast<std::uint64_t>(end - cursor) / 2)));
+        sf::Time time = sf::Time::Zero;
+        for (std::uint64_t i = 0; i < event_count; i++) {
+            time += sf::microseconds(Toolkit::read_signed_varint(cursor, end));
+            auto packed = Toolkit::read_binary<std::uint8_t>(cursor, end);
+            auto button = Input::index_to_button(packed >> 1);
+            if (not button) {
+                throw std::runtime_error("Invalid button index : "+std::to_string(packed >> 1));
+            }
+            auto type = (packed & 1) ? Input::EventType::Released : Input::EventType::Pressed;
+            replay.events.push_back({time, {*button, type}});
+        }
+        return replay;
+    }
+
+    std::uint64_t chart_hash(const Chart& chart) {
+        const auto& timings = chart.notes.get_timings();
+        const auto& durations = chart.notes.get_durations();
+        auto hash = Toolkit::fnv1a_64("");
+        hash = hash_value<std::uint64_t>(chart.resolution, hash);
+        for (std::size_t i = 0; i < chart.notes.size(); i++) {
+            hash = hash_value<std::int64_t>(timings[i], hash);
+            hash = hash_value<std::int64_t>(durations[i], hash);
+            hash = hash_value<std::uint8_t>(static_cast<std::uint8_t>(Input::button_to_index(chart.notes.position(i))), hash);
+            hash = hash_value<std::uint8_t>(static_cast<std::uint8_t>(Input::button_to_index(chart.notes.tail(i))), hash);
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <ghc/filesystem.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "../Input/Buttons.hpp"
+#include "../Input/Events.hpp"
+#include "Chart.hpp"
+
+namespace fs = ghc::filesystem;
+
+namespace Data {
+    struct ReplayEvent {
+        // music time the event was judged at
+        sf::Time time;
+        Input::ButtonEvent event;
+    };
+
+    // Every button event judged during a play, enough to grade it again the exact same way
+    struct Replay {
+        // chart_hash() of the chart that was played
+        std::uint64_t chart_hash = 0;
+        // audio offset the play was made with
+        sf::Time audio_offset;
+        fs::path song_folder;
+        std::string difficulty;
+        std::vector<ReplayEvent> events;
+
+        // Event times are stored as varint deltas in microseconds, around 4 bytes per event
+        void save(const fs::path& path) const;
+        // Throws std::runtime_error if the file can't be read
+        static Replay load(const fs::path& path);
+    };
+
+    // Changes whenever the notes of the chart change
+    std::uint64_t chart_hash(const Chart& chart);
+}
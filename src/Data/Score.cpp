@@ -5,19 +5,12 @@
 #include <SFML/System/Time.hpp>
 
 namespace Data {
-    std::size_t count_classic_scoring_events(const std::set<Note>& notes) {
-        std::size_t count = 0;
-        for (auto&& note : notes) {
-            if (note.duration > sf::Time::Zero) {
-                count += 2;
-            } else {
-                count += 1;
-            }
-        }
-        return count;
+    std::size_t count_classic_scoring_events(const NoteStore& notes) {
+        // long notes count twice : once for the tap and once for the release
+        return notes.size() + notes.long_note_count();
     }
 
-    ClassicScore::ClassicScore(const std::set<Note>& notes) :
+    ClassicScore::ClassicScore(const NoteStore& notes) :
         tap_event_count(count_classic_scoring_events(notes)),
         judgement_counts(5)
     {
@@ -7,13 +7,9 @@
 #include <unordered_map>
 
 #include "Note.hpp"
+#include "NoteStore.hpp"
 #include "GradedNote.hpp"
 
-// Forward declarations
-namespace Gameplay {
-    class Screen;
-}
-
 namespace Data {
     enum class Rating {
         EXC,
@@ -53,13 +49,14 @@ namespace Data {
         virtual void update(Judgement j) = 0;
     };
 
-    std::size_t count_classic_scoring_events(const std::set<Note>& notes);
+    std::size_t count_classic_scoring_events(const NoteStore& notes);
 
     // Classic jubeat scoring
     class ClassicScore final : public AbstractScore {
     public:
-        ClassicScore(const std::set<Note>& notes);
+        ClassicScore(const NoteStore& notes);
         int get_shutter() const;
+        std::size_t get_judgement_count(Judgement j) const {return judgement_counts.at(j);};
         int get_final_score() const override;
         int get_score() const override;
         Rating get_rating() const override;
@@ -71,7 +68,5 @@ namespace Data {
         int shutter_decrement_4x;
         const std::size_t tap_event_count;
         std::unordered_map<Judgement, std::size_t> judgement_counts;
-
-        friend class Gameplay::Screen;
     };
 }
\ No newline at end of file
@@ -1,12 +1,27 @@
 #include "Song.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <set>
+#include <unordered_map>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 #include <memon/memon.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include "../Toolkit/LRUCache.hpp"
+#include "../Toolkit/ParallelFor.hpp"
+#include "AudioDuration.hpp"
+#include "CompiledChart.hpp"
+#include "MemonMetadata.hpp"
 
 namespace fs = ghc::filesystem;
 
@@ -44,60 +59,407 @@ namespace Data {
         } 
     }
 
+    sf::Time Song::get_audio_duration() const {
+        auto audio_path = full_audio_path();
+        if (not audio_path or not fs::exists(*audio_path)) {
+            return sf::Time::Zero;
+        }
+        std::lock_guard lock{audio_duration_mutex};
+        auto audio_stamp = FileStamp::from_file(*audio_path);
+        if (not audio_duration or audio_duration->audio_stamp != audio_stamp) {
+            audio_duration = CachedAudioDuration{
+                audio_stamp,
+                probe_audio_duration(*audio_path).value_or(sf::Time::Zero)
+            };
+        }
+        return audio_duration->duration;
+    }
+
     SongList::SongList(const fs::path& jujube_path) :
-        songs()
+        songs(),
+        song_folder(jujube_path/"songs"),
+        compiled_charts_folder(jujube_path/"data"/"charts"),
+        song_index(jujube_path),
+        watcher(song_folder),
+        search_index(jujube_path)
     {
-        fs::path song_folder = jujube_path/"songs";
+        loading_thread = std::thread{&SongList::loading_main, this};
+    }
+
+    void SongList::loading_main() {
+        initial_scan();
+        // The watcher only hands folders out once they stayed quiet for a second,
+        // no need to ask much more often than that
+        while (not stop_loading) {
+            rescan_changed_folders();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
 
-        if (fs::exists(song_folder) and fs::is_directory(song_folder)) {
-            for (const auto& dir_item : fs::directory_iterator(song_folder)) {
-                if (dir_item.is_directory()) {
-                    songs.splice(songs.end(), recursiveSongSearch(dir_item.path()));
+    void SongList::initial_scan() {
+        sf::Clock scan_clock;
+        std::size_t found_songs = 0;
+        try {
+            std::vector<fs::path> songs_or_packs;
+            if (fs::exists(song_folder) and fs::is_directory(song_folder)) {
+                for (const auto& dir_item : fs::directory_iterator(song_folder)) {
+                    if (dir_item.is_directory()) {
+                        songs_or_packs.push_back(dir_item.path());
+                    }
+                }
+            }
+            const auto memon_paths = parallelSongSearch(songs_or_packs);
+            // Songs are handed out in small batches so the music select screen fills up progressively
+            const std::size_t batch_size = 64;
+            for (std::size_t start = 0; start < memon_paths.size() and not stop_loading; start += batch_size) {
+                std::vector<fs::path> batch{
+                    memon_paths.begin() + static_cast<std::ptrdiff_t>(start),
+                    memon_paths.begin() + static_cast<std::ptrdiff_t>(std::min(start + batch_size, memon_paths.size()))
+                };
+                auto batch_songs = load_songs(batch);
+                add_to_search_index(batch_songs);
+                std::lock_guard lock{loaded_songs_mutex};
+                for (const auto& song : batch_songs) {
+                    if (not song->chart_levels.empty()) {
+                        known_songs.emplace(song->get_memon_path().string(), song);
+                        loaded_songs.push_back(song);
+                        found_songs++;
+                    }
                 }
             }
+            song_index.save();
+            // songs that are gone can only be told apart once the whole scan is done
+            if (not stop_loading) {
+                std::unique_lock lock{search_mutex};
+                search_index.remove_unused();
+                search_index.save();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error while loading songs : " << e.what() << '\n';
         }
-        std::cout << "Loaded Data::SongList, found " << songs.size() << " songs" << '\n';
+        std::cout << "Loaded Data::SongList, found " << found_songs << " songs in ";
+        std::cout << scan_clock.getElapsedTime().asMilliseconds() << "ms using " << Toolkit::worker_count() << " threads (";
+        std::cout << song_index.hits << " from the song index, " << song_index.misses << " parsed)" << '\n';
+        loading = false;
     }
 
-    std::list<std::shared_ptr<Song>> recursiveSongSearch(fs::path song_or_pack) {
-        std::list<std::shared_ptr<Song>> res;
+    std::vector<std::shared_ptr<MemonSong>> SongList::load_songs(const std::vector<fs::path>& memon_paths) {
+        std::vector<FileStamp> stamps(memon_paths.size());
+        // One broken file only costs its own song, errors are printed once the threads are done
+        std::vector<std::string> errors(memon_paths.size());
+        Toolkit::parallel_for(memon_paths.size(), [&](std::size_t i){
+            try {
+                stamps[i] = FileStamp::from_file(memon_paths[i]);
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        });
 
-        // First try : any .memo file in the folder ?
-        fs::directory_iterator folder_memo{song_or_pack};
-        if (
-            std::any_of(
-                fs::begin(folder_memo),
-                fs::end(folder_memo),
-                [](const fs::directory_entry& de) {return de.path().extension() == ".memo";}
-            )
-        ) {
-            throw std::invalid_argument("jujube does not support .memo files for now ...");
+        // Songs stay in the same slot as their memon file so the final order does not depend on thread timings
+        std::vector<std::shared_ptr<MemonSong>> found_songs(memon_paths.size());
+        std::vector<std::size_t> to_parse;
+        for (std::size_t i = 0; i < memon_paths.size(); i++) {
+            if (not errors[i].empty()) {
+                continue;
+            }
+            if (auto entry = song_index.lookup(memon_paths[i], stamps[i])) {
+                found_songs[i] = std::make_shared<MemonSong>(memon_paths[i], compiled_charts_folder, *entry);
+            } else {
+                to_parse.push_back(i);
+            }
         }
-
-        // Second try : any .memon file in the folder ?
-        // if yes get the first one
-        fs::directory_iterator folder_memon{song_or_pack};
-        auto memon_path = std::find_if(
-            fs::begin(folder_memon),
-            fs::end(folder_memon),
-            [](const fs::directory_entry& de) {return de.path().extension() == ".memon";}
+        Toolkit::parallel_for(to_parse.size(), [&](std::size_t i){
+            auto slot = to_parse[i];
+            try {
+                found_songs[slot] = std::make_shared<MemonSong>(memon_paths[slot], compiled_charts_folder);
+            } catch (const std::exception& e) {
+                errors[slot] = e.what();
+            }
+        });
+        for (const auto& slot : to_parse) {
+            if (found_songs[slot]) {
+                song_index.insert(memon_paths[slot], found_songs[slot]->get_index_entry());
+            }
+        }
+        for (std::size_t i = 0; i < memon_paths.size(); i++) {
+            if (not errors[i].empty()) {
+                std::cerr << "Could not load " << memon_paths[i].string() << " : " << errors[i] << '\n';
+            }
+        }
+        found_songs.erase(
+            std::remove(found_songs.begin(), found_songs.end(), nullptr),
+            found_songs.end()
         );
-        if (memon_path != fs::end(folder_memon)) {
-            auto song = std::make_shared<MemonSong>(memon_path->path());
-            if (not song->chart_levels.empty()) {
-                res.push_back(song);
+        return found_songs;
+    }
+
+    void SongList::add_to_search_index(const std::vector<std::shared_ptr<MemonSong>>& new_songs) {
+        std::unique_lock lock{search_mutex};
+        for (const auto& song : new_songs) {
+            if (song->chart_levels.empty()) {
+                continue;
             }
-            return res;
+            auto id = search_index.add(song->get_memon_path().string(), song->get_stamp(), song->title, song->artist);
+            if (id >= songs_by_search_id.size()) {
+                songs_by_search_id.resize(id + 1);
+            }
+            songs_by_search_id[id] = song;
         }
-        // Nothing found : recurse in subfolders
-        for (auto& p : fs::directory_iterator(song_or_pack)) {
-            if (p.is_directory()) {
-                res.splice(res.end(), recursiveSongSearch(p));
+    }
+
+    std::vector<std::shared_ptr<Song>> SongList::search(const std::string& query) const {
+        std::shared_lock lock{search_mutex};
+        std::vector<std::shared_ptr<Song>> res;
+        for (const auto& id : search_index.search(query)) {
+            // songs loaded from data/search_index.bin but not found again yet have no slot
+            if (id < songs_by_search_id.size() and songs_by_search_id[id]) {
+                res.push_back(songs_by_search_id[id]);
             }
         }
         return res;
     }
 
+    namespace {
+        // true if path is folder or somewhere inside it
+        bool is_inside(const fs::path& path, const fs::path& folder) {
+            auto [folder_end, path_it] = std::mismatch(folder.begin(), folder.end(), path.begin(), path.end());
+            return folder_end == folder.end();
+        }
+    }
+
+    std::optional<SongListChanges> SongList::update_from_disk() {
+        SongListChanges changes;
+        {
+            std::lock_guard lock{loaded_songs_mutex};
+            changes.added.swap(loaded_songs);
+            changes.removed.swap(unloaded_songs);
+        }
+        if (changes.added.empty() and changes.removed.empty()) {
+            return {};
+        }
+        songs.remove_if([&](const std::shared_ptr<Song>& song){
+            return std::find(changes.removed.begin(), changes.removed.end(), song) != changes.removed.end();
+        });
+        removed_songs.insert(removed_songs.end(), changes.removed.begin(), changes.removed.end());
+        songs.insert(songs.end(), changes.added.begin(), changes.added.end());
+        return changes;
+    }
+
+    void SongList::rescan_changed_folders() {
+        auto changed_folders = watcher.take_changed_folders();
+        if (changed_folders.empty()) {
+            return;
+        }
+
+        // Something changing inside a song folder means that song has to be read again,
+        // something changing in a pack folder means the whole pack has to be searched again
+        std::set<fs::path> song_folders;
+        for (const auto& [_, song] : known_songs) {
+            song_folders.insert(song->folder);
+        }
+        std::vector<fs::path> subtrees;
+        for (auto folder : changed_folders) {
+            for (auto ancestor = folder; is_inside(ancestor, song_folder) and ancestor != song_folder; ancestor = ancestor.parent_path()) {
+                if (song_folders.find(ancestor) != song_folders.end()) {
+                    folder = ancestor;
+                }
+            }
+            subtrees.push_back(folder);
+        }
+        // No need to look at a folder twice if one of its parents is already going to be searched
+        std::sort(subtrees.begin(), subtrees.end());
+        std::vector<fs::path> top_subtrees;
+        for (const auto& subtree : subtrees) {
+            if (top_subtrees.empty() or not is_inside(subtree, top_subtrees.back())) {
+                top_subtrees.push_back(subtree);
+            }
+        }
+
+        std::vector<fs::path> songs_or_packs;
+        for (const auto& subtree : top_subtrees) {
+            if (not fs::is_directory(subtree)) {
+                continue;
+            }
+            // The watcher names the entries that changed right in the songs folder,
+            // getting the songs folder itself means it lost track and everything has to be searched.
+            // Files right in the songs folder are not songs
+            if (subtree == song_folder) {
+                for (const auto& dir_item : fs::directory_iterator(song_folder)) {
+                    if (dir_item.is_directory()) {
+                        songs_or_packs.push_back(dir_item.path());
+                    }
+                }
+            } else {
+                songs_or_packs.push_back(subtree);
+            }
+        }
+
+        std::vector<fs::path> memon_paths;
+        try {
+            memon_paths = parallelSongSearch(songs_or_packs);
+        } catch (const std::exception& e) {
+            std::cerr << "Error while looking for new songs : " << e.what() << '\n';
+            return;
+        }
+
+        // Songs whose memon file did not change are left untouched
+        std::unordered_map<std::string, std::shared_ptr<MemonSong>> previous_songs;
+        for (const auto& [memon_path, song] : known_songs) {
+            for (const auto& subtree : top_subtrees) {
+                if (is_inside(song->folder, subtree)) {
+                    previous_songs.emplace(memon_path, song);
+                    break;
+                }
+            }
+        }
+        std::vector<fs::path> to_load;
+        for (const auto& memon_path : memon_paths) {
+            auto previous = previous_songs.find(memon_path.string());
+            if (
+                previous != previous_songs.end()
+                and fs::exists(memon_path)
+                and previous->second->get_stamp() == FileStamp::from_file(memon_path)
+            ) {
+                previous_songs.erase(previous);
+            } else {
+                to_load.push_back(memon_path);
+            }
+        }
+
+        std::vector<std::shared_ptr<MemonSong>> new_songs;
+        try {
+            new_songs = load_songs(to_load);
+        } catch (const std::exception& e) {
+            std::cerr << "Error while loading new songs : " << e.what() << '\n';
+            return;
+        }
+
+        std::size_t added = 0;
+        {
+            std::unique_lock lock{search_mutex};
+            for (const auto& [memon_path, _] : previous_songs) {
+                search_index.remove(memon_path);
+            }
+        }
+        add_to_search_index(new_songs);
+        {
+            std::lock_guard lock{loaded_songs_mutex};
+            for (const auto& [memon_path, song] : previous_songs) {
+                known_songs.erase(memon_path);
+                // a song that was never handed out can just be taken back
+                auto not_handed_out = std::find(loaded_songs.begin(), loaded_songs.end(), song);
+                if (not_handed_out != loaded_songs.end()) {
+                    loaded_songs.erase(not_handed_out);
+                } else {
+                    unloaded_songs.push_back(song);
+                }
+            }
+            for (const auto& song : new_songs) {
+                if (not song->chart_levels.empty()) {
+                    known_songs[song->get_memon_path().string()] = song;
+                    loaded_songs.push_back(song);
+                    added++;
+                }
+            }
+        }
+        if (added == 0 and previous_songs.empty()) {
+            return;
+        }
+        std::cout << "Updated Data::SongList, " << added << " songs added, ";
+        std::cout << previous_songs.size() << " songs removed" << '\n';
+    }
+
+    SongList::~SongList() {
+        stop_loading = true;
+        loading_thread.join();
+        for (const auto& song : songs) {
+            if (auto memon_song = std::dynamic_pointer_cast<MemonSong>(song)) {
+                song_index.insert(memon_song->get_memon_path(), memon_song->get_index_entry());
+            }
+        }
+        song_index.save();
+        search_index.save();
+    }
+
+    std::vector<fs::path> parallelSongSearch(const std::vector<fs::path>& songs_or_packs) {
+        // Folders left to explore are shared between all the threads,
+        // whoever is free takes the next one and pushes the subfolders it finds back
+        std::deque<fs::path> folders{songs_or_packs.begin(), songs_or_packs.end()};
+        std::size_t folders_being_explored = 0;
+        std::vector<fs::path> memon_paths;
+        std::exception_ptr first_error;
+        std::mutex mutex;
+        std::condition_variable folders_changed;
+
+        // Lists the folder only once and returns either the memon file it contains or its subfolders
+        auto explore = [](const fs::path& song_or_pack) {
+            std::optional<fs::path> memon_path;
+            std::vector<fs::path> subfolders;
+            for (const auto& dir_item : fs::directory_iterator(song_or_pack)) {
+                const auto extension = dir_item.path().extension();
+                if (extension == ".memo") {
+                    throw std::invalid_argument("jujube does not support .memo files for now ...");
+                } else if (extension == ".memon") {
+                    // if there are many, get the first one
+                    if (not memon_path) {
+                        memon_path = dir_item.path();
+                    }
+                } else if (dir_item.is_directory()) {
+                    subfolders.push_back(dir_item.path());
+                }
+            }
+            return std::make_pair(memon_path, subfolders);
+        };
+
+        auto work = [&](){
+            std::unique_lock lock{mutex};
+            while (true) {
+                folders_changed.wait(lock, [&](){
+                    return not folders.empty() or folders_being_explored == 0 or first_error;
+                });
+                if (folders.empty() or first_error) {
+                    return;
+                }
+                auto folder = folders.front();
+                folders.pop_front();
+                folders_being_explored++;
+                lock.unlock();
+                try {
+                    auto [memon_path, subfolders] = explore(folder);
+                    lock.lock();
+                    if (memon_path) {
+                        memon_paths.push_back(*memon_path);
+                    } else {
+                        folders.insert(folders.end(), subfolders.begin(), subfolders.end());
+                    }
+                } catch (...) {
+                    if (not lock.owns_lock()) {
+                        lock.lock();
+                    }
+                    if (not first_error) {
+                        first_error = std::current_exception();
+                    }
+                }
+                folders_being_explored--;
+                folders_changed.notify_all();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (std::size_t t = 1; t < Toolkit::worker_count(); t++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (first_error) {
+            std::rethrow_exception(first_error);
+        }
+        std::sort(memon_paths.begin(), memon_paths.end());
+        return memon_paths;
+    }
+
     TimeBounds SongDifficulty::get_time_bounds() const {
         auto chart = song.get_chart(difficulty);
         if (not chart) {
@@ -105,24 +467,19 @@ namespace Data {
         }
         TimeBounds time_bounds = {sf::Time::Zero, sf::seconds(1)};
         time_bounds += chart->get_time_bounds_from_notes();
-        sf::Music m;
-        if (m.openFromFile(*song.full_audio_path())) {
-            time_bounds += {sf::Time::Zero, m.getDuration()};
-        }
+        time_bounds += {sf::Time::Zero, song.get_audio_duration()};
         time_bounds.end += sf::seconds(1);
         return time_bounds;
     }
 
-    MemonSong::MemonSong(const fs::path& t_memon_path) :
-        memon_path(t_memon_path)
+    MemonSong::MemonSong(const fs::path& t_memon_path, const fs::path& t_compiled_charts_folder) :
+        memon_path(t_memon_path),
+        compiled_charts_folder(t_compiled_charts_folder),
+        stamp(FileStamp::from_file(t_memon_path))
     {
         auto song_folder = t_memon_path.parent_path();
         folder = song_folder;
-        stepland::memon m;
-        {
-            std::ifstream file(t_memon_path);
-            file >> m;
-        }
+        auto m = read_memon_metadata(t_memon_path);
         this->title = m.song_title;
         this->artist = m.artist;
         if (not m.album_cover_path.empty()) {
@@ -131,28 +488,75 @@ namespace Data {
         if (not m.music_path.empty()) {
             this->audio.emplace(m.music_path);
         }
-        if (m.preview) {
-            this->preview.emplace(
-                sf::seconds(m.preview->position),
-                sf::seconds(m.preview->duration)
-            );
-        }
-        for (const auto& [difficulty, chart] : m.charts) {
-            this->chart_levels[difficulty] = chart.level;
+        this->preview = m.preview;
+        for (const auto& [difficulty, level] : m.chart_levels) {
+            this->chart_levels[difficulty] = level;
         }
     }
 
-    std::optional<Chart> MemonSong::get_chart(const std::string& difficulty) const {
-        stepland::memon m;
-        {
-            std::ifstream file(memon_path);
-            file >> m;
+    MemonSong::MemonSong(const fs::path& t_memon_path, const fs::path& t_compiled_charts_folder, const SongIndexEntry& entry) :
+        memon_path(t_memon_path),
+        compiled_charts_folder(t_compiled_charts_folder),
+        stamp(entry.stamp)
+    {
+        folder = t_memon_path.parent_path();
+        title = entry.title;
+        artist = entry.artist;
+        cover = entry.cover;
+        audio = entry.audio;
+        preview = entry.preview;
+        for (const auto& [difficulty, level] : entry.chart_levels) {
+            chart_levels[difficulty] = level;
         }
-        auto chart = m.charts.find(difficulty);
-        if (chart == m.charts.end()) {
-            return {};
-        } else {
-            return Chart(m, difficulty);
+        audio_duration = entry.audio_duration;
+    }
+
+    SongIndexEntry MemonSong::get_index_entry() const {
+        SongIndexEntry entry;
+        entry.stamp = stamp;
+        entry.title = title;
+        entry.artist = artist;
+        entry.cover = cover;
+        entry.audio = audio;
+        entry.preview = preview;
+        for (const auto& [difficulty, level] : chart_levels) {
+            entry.chart_levels.emplace_back(difficulty, level);
         }
+        std::lock_guard lock{audio_duration_mutex};
+        entry.audio_duration = audio_duration;
+        return entry;
+    }
+
+    std::shared_ptr<const Chart> MemonSong::get_chart(const std::string& difficulty) const {
+        // A song selection asks for the same chart many times (gameplay, time bounds, density graph, results ...)
+        // so the last few parsed charts are kept around
+        static Toolkit::LRUCache<std::string, std::shared_ptr<const Chart>> chart_cache{8};
+        // the stamp is part of the key so that a song rescanned after its file was edited does not get the old chart
+        auto key = memon_path.string();
+        key.push_back('\0');
+        key += std::to_string(stamp.mtime);
+        key.push_back('\0');
+        key += std::to_string(stamp.size);
+        key.push_back('\0');
+        key += difficulty;
+        return chart_cache.get_or_load(key, [&]() -> std::shared_ptr<const Chart> {
+            auto compiled_path = compiled_chart_path(compiled_charts_folder, memon_path, difficulty);
+            auto memon_stamp = FileStamp::from_file(memon_path);
+            if (auto compiled_chart = load_compiled_chart(compiled_path, memon_stamp)) {
+                return std::make_shared<const Chart>(std::move(*compiled_chart));
+            }
+            stepland::memon m;
+            {
+                std::ifstream file(memon_path);
+                file >> m;
+            }
+            auto chart = m.charts.find(difficulty);
+            if (chart == m.charts.end()) {
+                return nullptr;
+            }
+            auto parsed_chart = std::make_shared<const Chart>(m, difficulty);
+            save_compiled_chart(compiled_path, *parsed_chart, memon_stamp);
+            return parsed_chart;
+        });
     }
 }
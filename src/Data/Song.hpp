@@ -1,18 +1,26 @@
 #pragma once
 
+#include <atomic>
 #include <iterator>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <variant>
+#include <vector>
 #include <unordered_map>
 
 #include <ghc/filesystem.hpp>
 #include <SFML/Audio.hpp>
 
 #include "Chart.hpp"
+#include "SongFolderWatcher.hpp"
+#include "SongIndex.hpp"
+#include "SongSearchIndex.hpp"
 #include "TimeBounds.hpp"
 
 namespace fs = ghc::filesystem;
@@ -42,20 +50,28 @@ namespace Data {
 
         virtual std::optional<fs::path> full_cover_path() const;
         virtual std::optional<fs::path> full_audio_path() const;
+        // Length of the audio file, zero if there's none or it can't be read
+        // It's only probed once, then again if the audio file changes
+        sf::Time get_audio_duration() const;
 
-        virtual std::optional<Chart> get_chart(const std::string& difficulty) const = 0;
+        // Returns nullptr if the song has no such chart,
+        // charts are immutable and shared between everyone who asks for them
+        virtual std::shared_ptr<const Chart> get_chart(const std::string& difficulty) const = 0;
 
         static bool sort_by_title(const Data::Song& a, const Data::Song& b) {
             return a.title < b.title;
         }
         virtual ~Song() = default;
+    protected:
+        mutable std::mutex audio_duration_mutex;
+        mutable std::optional<CachedAudioDuration> audio_duration;
     };
 
     struct SongDifficulty {
         const Data::Song& song;
         const std::string& difficulty;
 
-        std::optional<Chart> get_chart() const {return song.get_chart(difficulty);};
+        std::shared_ptr<const Chart> get_chart() const {return song.get_chart(difficulty);};
 
         // Get the total play interval for this chart :
         // if there's no audio and no notes, returns a one second inteval starting at sf::Time::Zero
@@ -73,10 +89,19 @@ namespace Data {
     };
 
     struct MemonSong : public Song {
-        explicit MemonSong(const fs::path& memon_path);
-        std::optional<Chart> get_chart(const std::string& difficulty) const;
+        // compiled_charts_folder is where compiled versions of the charts are cached
+        MemonSong(const fs::path& memon_path, const fs::path& compiled_charts_folder);
+        // Build the song from what the song index remembers about the file, without parsing it
+        MemonSong(const fs::path& memon_path, const fs::path& compiled_charts_folder, const SongIndexEntry& entry);
+        // Charts are parsed at most once as long as they stay in the chart cache
+        std::shared_ptr<const Chart> get_chart(const std::string& difficulty) const;
+        SongIndexEntry get_index_entry() const;
+        const fs::path& get_memon_path() const {return memon_path;};
+        const FileStamp& get_stamp() const {return stamp;};
     private:
         fs::path memon_path;
+        fs::path compiled_charts_folder;
+        FileStamp stamp;
     };
 
     /*
@@ -87,14 +112,69 @@ namespace Data {
     };
     */
 
+    struct SongListChanges {
+        std::vector<std::shared_ptr<Song>> added;
+        std::vector<std::shared_ptr<Song>> removed;
+    };
+
     // Class holding all the necessary song data to run the Music Select screen
+    // Songs are searched for in a background thread, which then keeps rescanning
+    // the folders that change on disk, songs only show up in (or leave)
+    // the songs attribute as update_from_disk gets called
     class SongList {
     public:
         SongList(const fs::path& jujube_path);
+        // Saves the song index again, with the audio durations found since startup
+        ~SongList();
+        SongList(const SongList&) = delete;
+        SongList& operator=(const SongList&) = delete;
         std::list<std::shared_ptr<Song>> songs;
+
+        // Hands out what the loading thread found since the last call,
+        // songs from the initial scan and songs added or removed on disk since then,
+        // returns empty if nothing changed
+        std::optional<SongListChanges> update_from_disk();
+        // true until the initial scan is done
+        bool is_loading() const {return loading;};
+        // Songs whose title or artist contains the query, ignoring case.
+        // Ascii queries shorter than 3 characters only match the start of words
+        // May include songs the initial scan found but update_from_disk has not handed out yet
+        std::vector<std::shared_ptr<Song>> search(const std::string& query) const;
+    private:
+        // Runs the initial scan then keeps rescanning what changes until stop_loading is set
+        void loading_main();
+        void initial_scan();
+        // Songs that changed are only pushed to loaded_songs and unloaded_songs
+        void rescan_changed_folders();
+        // Reads the songs from the index or parses them, in the same order as the paths given.
+        // Files that cannot be read are logged and left out
+        std::vector<std::shared_ptr<MemonSong>> load_songs(const std::vector<fs::path>& memon_paths);
+        void add_to_search_index(const std::vector<std::shared_ptr<MemonSong>>& new_songs);
+
+        fs::path song_folder;
+        fs::path compiled_charts_folder;
+        SongIndex song_index;
+        SongFolderWatcher watcher;
+        // Shared between the loading thread and whoever searches
+        SongSearchIndex search_index;
+        std::vector<std::shared_ptr<Song>> songs_by_search_id;
+        mutable std::shared_mutex search_mutex;
+        // Removed songs are kept alive since other parts of the game may still be holding references to them
+        std::vector<std::shared_ptr<Song>> removed_songs;
+
+        std::atomic<bool> loading = true;
+        std::atomic<bool> stop_loading = false;
+        // Every song handed out or about to be, by memon path, only touched by the loading thread
+        std::unordered_map<std::string, std::shared_ptr<MemonSong>> known_songs;
+        // Found or removed by the loading thread but not handed out yet
+        std::vector<std::shared_ptr<Song>> loaded_songs;
+        std::vector<std::shared_ptr<Song>> unloaded_songs;
+        std::mutex loaded_songs_mutex;
+        std::thread loading_thread;
     };
 
-    // Returns the folders conscidered to contain a valid song
+    // Returns the memon file of every folder conscidered to contain a valid song, sorted by path
+    // The folders are explored recursively from several threads at once
     // classic memo files should have the .memo extension
-    std::list<std::shared_ptr<Song>> recursiveSongSearch(fs::path song_or_pack);
+    std::vector<fs::path> parallelSongSearch(const std::vector<fs::path>& songs_or_packs);
 }
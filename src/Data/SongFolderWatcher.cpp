@@ -0,0 +1,138 @@
+#include "SongFolderWatcher.hpp"
+
+#include <iostream>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace Data {
+
+    #ifdef __linux__
+        namespace {
+            const std::uint32_t watched_events = (
+                IN_CREATE
+                | IN_DELETE
+                | IN_MOVED_FROM
+                | IN_MOVED_TO
+                | IN_CLOSE_WRITE
+                | IN_ONLYDIR
+            );
+        }
+
+        SongFolderWatcher::SongFolderWatcher(const fs::path& t_songs_folder) :
+            songs_folder(t_songs_folder)
+        {
+            if (not fs::is_directory(songs_folder)) {
+                return;
+            }
+            inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (inotify_fd == -1 or stop_fd == -1) {
+                std::cerr << "Could not start watching the songs folder, new songs will only show up after a restart" << '\n';
+                return;
+            }
+            watching_thread = std::thread{&SongFolderWatcher::watch_loop, this};
+        }
+
+        SongFolderWatcher::~SongFolderWatcher() {
+            if (watching_thread.joinable()) {
+                std::uint64_t one = 1;
+                [[maybe_unused]] auto written = write(stop_fd, &one, sizeof(one));
+                watching_thread.join();
+            }
+            if (inotify_fd != -1) {
+                close(inotify_fd);
+            }
+            if (stop_fd != -1) {
+                close(stop_fd);
+            }
+        }
+
+        void SongFolderWatcher::watch_recursively(const fs::path& folder) {
+            int wd = inotify_add_watch(inotify_fd, folder.c_str(), watched_events);
+            if (wd == -1) {
+                return;
+            }
+            watched_folders[wd] = folder;
+            std::error_code ec;
+            for (const auto& dir_item : fs::directory_iterator(folder, ec)) {
+                if (dir_item.is_directory()) {
+                    watch_recursively(dir_item.path());
+                }
+            }
+        }
+
+        void SongFolderWatcher::watch_loop() {
+            // Setting up the watches means walking the whole songs folder,
+            // this is done here so it does not slow the startup down
+            watch_recursively(songs_folder);
+            alignas(inotify_event) char buffer[4096];
+            pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {stop_fd, POLLIN, 0}};
+            while (true) {
+                if (poll(fds, 2, -1) == -1) {
+                    continue;
+                }
+                if (fds[1].revents & POLLIN) {
+                    return;
+                }
+                auto length = read(inotify_fd, buffer, sizeof(buffer));
+                if (length <= 0) {
+                    continue;
+                }
+                std::set<fs::path> folders;
+                for (char* ptr = buffer; ptr < buffer + length;) {
+                    auto event = reinterpret_cast<const inotify_event*>(ptr);
+                    ptr += sizeof(inotify_event) + event->len;
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        // We lost track of what happened, everything has to be checked
+                        folders.insert(songs_folder);
+                        continue;
+                    }
+                    if (event->mask & IN_IGNORED) {
+                        watched_folders.erase(event->wd);
+                        continue;
+                    }
+                    auto folder = watched_folders.find(event->wd);
+                    if (folder == watched_folders.end()) {
+                        continue;
+                    }
+                    // Anything in the songs folder itself is a whole song or pack,
+                    // only the entry that changed needs a look, not every other song
+                    if (folder->second == songs_folder and event->len > 0) {
+                        folders.insert(songs_folder/event->name);
+                    } else {
+                        folders.insert(folder->second);
+                    }
+                    // inotify is not recursive, new folders need their own watch
+                    if ((event->mask & IN_ISDIR) and (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                        watch_recursively(folder->second/event->name);
+                    }
+                }
+                std::lock_guard lock{changes_mutex};
+                changed_folders.insert(folders.begin(), folders.end());
+                time_since_last_change.restart();
+            }
+        }
+    #else
+        SongFolderWatcher::SongFolderWatcher(const fs::path& t_songs_folder) :
+            songs_folder(t_songs_folder)
+        {
+        }
+
+        SongFolderWatcher::~SongFolderWatcher() = default;
+    #endif
+
+    std::vector<fs::path> SongFolderWatcher::take_changed_folders() {
+        std::lock_guard lock{changes_mutex};
+        if (changed_folders.empty() or time_since_last_change.getElapsedTime() < sf::seconds(1)) {
+            return {};
+        }
+        std::vector<fs::path> res{changed_folders.begin(), changed_folders.end()};
+        changed_folders.clear();
+        return res;
+    }
+}
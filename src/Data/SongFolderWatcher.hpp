@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ghc/filesystem.hpp>
+#include <SFML/System/Clock.hpp>
+
+namespace fs = ghc::filesystem;
+
+namespace Data {
+    // Watches the songs folder and everything under it for changes from another thread
+    // Only implemented on Linux (inotify), elsewhere it never reports anything
+    class SongFolderWatcher {
+    public:
+        explicit SongFolderWatcher(const fs::path& t_songs_folder);
+        ~SongFolderWatcher();
+        SongFolderWatcher(const SongFolderWatcher&) = delete;
+        SongFolderWatcher& operator=(const SongFolderWatcher&) = delete;
+
+        // Returns the folders in which something was added, removed or modified,
+        // for the songs folder itself it's the entries that changed instead.
+        // Getting the songs folder back means changes were lost and everything has to be checked.
+        // Changes are only handed out once the folder stayed quiet for a second,
+        // this way a pack being copied over gets picked up in one go
+        std::vector<fs::path> take_changed_folders();
+    private:
+        void watch_recursively(const fs::path& folder);
+        void watch_loop();
+
+        fs::path songs_folder;
+        int inotify_fd = -1;
+        // written to in the destructor to wake the watching thread up
+        int stop_fd = -1;
+        // only touched by the watching thread once it has started
+        std::unordered_map<int, fs::path> watched_folders;
+        std::thread watching_thread;
+
+        std::mutex changes_mutex;
+        std::set<fs::path> changed_folders;
+        sf::Clock time_since_last_change;
+    };
+}
@@ -0,0 +1,152 @@
+#include "SongIndex.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "../Toolkit/BinaryIO.hpp"
+
+namespace Data {
+
+    namespace {
+        const std::string song_index_magic = "jujube song index";
+        // Bump this whenever the layout of the file changes, outdated indexes are simply ignored
+        const std::uint32_t song_index_version = 3;
+
+        void write_entry(std::ostream& out, const std::string& memon_path, const SongIndexEntry& entry) {
+            Toolkit::write_binary_string(out, memon_path);
+            Toolkit::write_binary<std::int64_t>(out, entry.stamp.mtime);
+            Toolkit::write_binary<std::uint64_t>(out, entry.stamp.size);
+            Toolkit::write_binary_string(out, entry.title);
+            Toolkit::write_binary_string(out, entry.artist);
+            Toolkit::write_binary<std::uint8_t>(out, entry.cover.has_value());
+            if (entry.cover) {
+                Toolkit::write_binary_string(out, entry.cover->string());
+            }
+            Toolkit::write_binary<std::uint8_t>(out, entry.audio.has_value());
+            if (entry.audio) {
+                Toolkit::write_binary_string(out, entry.audio->string());
+            }
+            Toolkit::write_binary<std::uint8_t>(out, entry.preview.has_value());
+            if (entry.preview) {
+                Toolkit::write_binary<std::int64_t>(out, entry.preview->offset.asMicroseconds());
+                Toolkit::write_binary<std::int64_t>(out, entry.preview->length.asMicroseconds());
+            }
+            Toolkit::write_binary<std::uint32_t>(out, static_cast<std::uint32_t>(entry.chart_levels.size()));
+            for (const auto& [difficulty, level] : entry.chart_levels) {
+                Toolkit::write_binary_string(out, difficulty);
+                Toolkit::write_binary<std::uint32_t>(out, level);
+            }
+            Toolkit::write_binary<std::uint8_t>(out, entry.audio_duration.has_value());
+            if (entry.audio_duration) {
+                Toolkit::write_binary<std::int64_t>(out, entry.audio_duration->audio_stamp.mtime);
+                Toolkit::write_binary<std::uint64_t>(out, entry.audio_duration->audio_stamp.size);
+                Toolkit::write_binary<std::int64_t>(out, entry.audio_duration->duration.asMicroseconds());
+            }
+        }
+
+        std::pair<std::string, SongIndexEntry> read_entry(std::istream& in) {
+            auto memon_path = Toolkit::read_binary_string(in);
+            SongIndexEntry entry;
+            entry.stamp.mtime = Toolkit::read_binary<std::int64_t>(in);
+            entry.stamp.size = Toolkit::read_binary<std::uint64_t>(in);
+            entry.title = Toolkit::read_binary_string(in);
+            entry.artist = Toolkit::read_binary_string(in);
+            if (Toolkit::read_binary<std::uint8_t>(in)) {
+                entry.cover.emplace(Toolkit::read_binary_string(in));
+            }
+            if (Toolkit::read_binary<std::uint8_t>(in)) {
+                entry.audio.emplace(Toolkit::read_binary_string(in));
+            }
+            if (Toolkit::read_binary<std::uint8_t>(in)) {
+                auto offset = sf::microseconds(Toolkit::read_binary<std::int64_t>(in));
+                auto length = sf::microseconds(Toolkit::read_binary<std::int64_t>(in));
+                entry.preview.emplace(offset, length);
+            }
+            auto chart_count = Toolkit::read_binary<std::uint32_t>(in);
+            for (std::uint32_t i = 0; i < chart_count; i++) {
+                auto difficulty = Toolkit::read_binary_string(in);
+                auto level = Toolkit::read_binary<std::uint32_t>(in);
+                entry.chart_levels.emplace_back(difficulty, level);
+            }
+            if (Toolkit::read_binary<std::uint8_t>(in)) {
+                CachedAudioDuration audio_duration;
+                audio_duration.audio_stamp.mtime = Toolkit::read_binary<std::int64_t>(in);
+                audio_duration.audio_stamp.size = Toolkit::read_binary<std::uint64_t>(in);
+                audio_duration.duration = sf::microseconds(Toolkit::read_binary<std::int64_t>(in));
+                entry.audio_duration = audio_duration;
+            }
+            return {memon_path, entry};
+        }
+    }
+
+    FileStamp FileStamp::from_file(const fs::path& path) {
+        FileStamp stamp;
+        stamp.mtime = static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count());
+        stamp.size = static_cast<std::uint64_t>(fs::file_size(path));
+        return stamp;
+    }
+
+    SongIndex::SongIndex(const fs::path& jujube_path) :
+        m_index_path(jujube_path/"data"/"song_index.bin")
+    {
+        if (not fs::exists(m_index_path)) {
+            return;
+        }
+        std::ifstream file{m_index_path, std::ios::binary};
+        try {
+            if (Toolkit::read_binary_string(file) != song_index_magic) {
+                throw std::runtime_error("not a song index");
+            }
+            if (Toolkit::read_binary<std::uint32_t>(file) != song_index_version) {
+                std::cout << "data/song_index.bin is outdated, every song will be parsed again" << '\n';
+                return;
+            }
+            auto entry_count = Toolkit::read_binary<std::uint64_t>(file);
+            m_loaded_entries.reserve(entry_count);
+            for (std::uint64_t i = 0; i < entry_count; i++) {
+                m_loaded_entries.insert(read_entry(file));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error while loading data/song_index.bin : " << e.what() << '\n';
+            std::cerr << "Every song will be parsed again" << '\n';
+            m_loaded_entries.clear();
+        }
+    }
+
+    std::optional<SongIndexEntry> SongIndex::lookup(const fs::path& memon_path, const FileStamp& stamp) {
+        auto it = m_loaded_entries.find(memon_path.string());
+        if (it == m_loaded_entries.end() or it->second.stamp != stamp) {
+            misses++;
+            return {};
+        }
+        hits++;
+        m_entries[it->first] = it->second;
+        return it->second;
+    }
+
+    void SongIndex::insert(const fs::path& memon_path, const SongIndexEntry& entry) {
+        m_entries[memon_path.string()] = entry;
+    }
+
+    void SongIndex::save() const {
+        auto data_folder = m_index_path.parent_path();
+        if (not fs::exists(data_folder)) {
+            fs::create_directory(data_folder);
+        }
+        if (not fs::is_directory(data_folder)) {
+            std::cerr << "Can't create data folder to save the song index, a file named 'data' exists" << '\n';
+            return;
+        }
+        std::ofstream file{m_index_path, std::ios::binary | std::ios::trunc};
+        Toolkit::write_binary_string(file, song_index_magic);
+        Toolkit::write_binary<std::uint32_t>(file, song_index_version);
+        Toolkit::write_binary<std::uint64_t>(file, m_entries.size());
+        for (const auto& [memon_path, entry] : m_entries) {
+            write_entry(file, memon_path, entry);
+        }
+        if (not file) {
+            std::cerr << "Error while saving data/song_index.bin" << '\n';
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ghc/filesystem.hpp>
+#include <SFML/Audio.hpp>
+
+namespace fs = ghc::filesystem;
+
+namespace Data {
+
+    // Last modification time and size of a file, used to tell if what we cached about it is still valid
+    struct FileStamp {
+        std::int64_t mtime = 0;
+        std::uint64_t size = 0;
+
+        static FileStamp from_file(const fs::path& path);
+
+        bool operator==(const FileStamp& rhs) const {
+            return mtime == rhs.mtime and size == rhs.size;
+        };
+        bool operator!=(const FileStamp& rhs) const {
+            return not(rhs == *this);
+        };
+    };
+
+    // Length of an audio file, only valid as long as the file keeps the same stamp
+    struct CachedAudioDuration {
+        FileStamp audio_stamp;
+        sf::Time duration;
+    };
+
+    // Everything the Music Select screen needs to know about a .memon file
+    struct SongIndexEntry {
+        FileStamp stamp;
+        std::string title;
+        std::string artist;
+        std::optional<fs::path> cover;
+        std::optional<fs::path> audio;
+        std::optional<sf::Music::TimeSpan> preview;
+        std::vector<std::pair<std::string, unsigned int>> chart_levels;
+        std::optional<CachedAudioDuration> audio_duration;
+    };
+
+    // Binary cache of the metadata of every .memon file found during the last song scan
+    // it lives in data/song_index.bin and allows SongList to only parse the files that changed
+    class SongIndex {
+    public:
+        explicit SongIndex(const fs::path& jujube_path);
+        // Returns the cached entry if the file has not changed since it was indexed,
+        // entries found this way are kept for the next save
+        std::optional<SongIndexEntry> lookup(const fs::path& memon_path, const FileStamp& stamp);
+        void insert(const fs::path& memon_path, const SongIndexEntry& entry);
+        // Only the entries looked up or inserted since loading get saved,
+        // this way songs deleted from the songs folder are forgotten
+        void save() const;
+
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    private:
+        fs::path m_index_path;
+        std::unordered_map<std::string, SongIndexEntry> m_loaded_entries;
+        std::unordered_map<std::string, SongIndexEntry> m_entries;
+    };
+}
@@ -0,0 +1,367 @@
+#include "SongSearchIndex.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "../Toolkit/BinaryIO.hpp"
+
+namespace Data {
+
+    namespace {
+        const std::string search_index_magic = "jujube search index";
+        // Bump this whenever the layout of the file or the case folding changes
+        const std::uint32_t search_index_version = 1;
+
+        const char32_t replacement_character = 0xFFFD;
+
+        char32_t fold_code_point(char32_t c) {
+            if (U'A' <= c and c <= U'Z') {
+                return c + 0x20;
+            }
+            if (c < 0x80) {
+                return c;
+            }
+            // Fullwidth ASCII
+            if (0xFF01 <= c and c <= 0xFF5E) {
+                return fold_code_point(c - 0xFEE0);
+            }
+            // Latin-1, except the multiplication sign
+            if (0xC0 <= c and c <= 0xDE and c != 0xD7) {
+                return c + 0x20;
+            }
+            // Latin Extended-A, mostly upper / lower case pairs
+            if ((0x100 <= c and c <= 0x137) or (0x14A <= c and c <= 0x177)) {
+                return c | 1;
+            }
+            if ((0x139 <= c and c <= 0x148) or (0x179 <= c and c <= 0x17E)) {
+                return (c % 2 == 1) ? c + 1 : c;
+            }
+            if (c == 0x178) {
+                return 0xFF;
+            }
+            // Greek
+            if (0x391 <= c and c <= 0x3A9 and c != 0x3A2) {
+                return c + 0x20;
+            }
+            // Cyrillic
+            if (0x400 <= c and c <= 0x40F) {
+                return c + 0x50;
+            }
+            if (0x410 <= c and c <= 0x42F) {
+                return c + 0x20;
+            }
+            // Katakana to Hiragana
+            if (0x30A1 <= c and c <= 0x30F6) {
+                return c - 0x60;
+            }
+            return c;
+        }
+
+        std::uint64_t trigram_key(const char32_t* chars) {
+            return (
+                (static_cast<std::uint64_t>(chars[0] & 0x1FFFFF) << 42)
+                | (static_cast<std::uint64_t>(chars[1] & 0x1FFFFF) << 21)
+                | static_cast<std::uint64_t>(chars[2] & 0x1FFFFF)
+            );
+        }
+
+        std::vector<std::uint64_t> unique_trigrams(const std::u32string& text) {
+            std::vector<std::uint64_t> keys;
+            for (std::size_t i = 0; i + 3 <= text.size(); i++) {
+                keys.push_back(trigram_key(text.data()+i));
+            }
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            return keys;
+        }
+
+        bool is_word_separator(char32_t c) {
+            return c < 0x80 and not (
+                (U'a' <= c and c <= U'z')
+                or (U'0' <= c and c <= U'9')
+            );
+        }
+    }
+
+    std::u32string fold_for_search(std::string_view utf8) {
+        std::u32string res;
+        res.reserve(utf8.size());
+        std::size_t i = 0;
+        while (i < utf8.size()) {
+            auto lead = static_cast<unsigned char>(utf8[i]);
+            std::size_t length;
+            char32_t c;
+            if (lead < 0x80) {
+                length = 1;
+                c = lead;
+            } else if ((lead & 0xE0) == 0xC0) {
+                length = 2;
+                c = lead & 0x1F;
+            } else if ((lead & 0xF0) == 0xE0) {
+                length = 3;
+                c = lead & 0x0F;
+            } else if ((lead & 0xF8) == 0xF0) {
+                length = 4;
+                c = lead & 0x07;
+            } else {
+                res.push_back(replacement_character);
+                i++;
+                continue;
+            }
+            bool valid = i + length <= utf8.size();
+            for (std::size_t j = 1; valid and j < length; j++) {
+                auto continuation = static_cast<unsigned char>(utf8[i+j]);
+                if ((continuation & 0xC0) != 0x80) {
+                    valid = false;
+                } else {
+                    c = (c << 6) | (continuation & 0x3F);
+                }
+            }
+            if (not valid) {
+                res.push_back(replacement_character);
+                i++;
+                continue;
+            }
+            res.push_back(fold_code_point(c));
+            i += length;
+        }
+        return res;
+    }
+
+    SongSearchIndex::SongSearchIndex(const fs::path& jujube_path) :
+        m_index_path(jujube_path/"data"/"search_index.bin")
+    {
+        if (not fs::exists(m_index_path)) {
+            return;
+        }
+        std::ifstream file{m_index_path, std::ios::binary};
+        try {
+            if (Toolkit::read_binary_string(file) != search_index_magic) {
+                throw std::runtime_error("not a search index");
+            }
+            if (Toolkit::read_binary<std::uint32_t>(file) != search_index_version) {
+                std::cout << "data/search_index.bin is outdated, every song will be indexed again" << '\n';
+                return;
+            }
+            auto document_count = Toolkit::read_binary<std::uint32_t>(file);
+            m_documents.reserve(document_count);
+            for (std::uint32_t id = 0; id < document_count; id++) {
+                Document document;
+                document.key = Toolkit::read_binary_string(file);
+                document.stamp.mtime = Toolkit::read_binary<std::int64_t>(file);
+                document.stamp.size = Toolkit::read_binary<std::uint64_t>(file);
+                document.text.resize(Toolkit::read_binary<std::uint32_t>(file));
+                if (not file.read(reinterpret_cast<char*>(document.text.data()), static_cast<std::streamsize>(document.text.size()*sizeof(char32_t)))) {
+                    throw std::runtime_error("Unexpected end of file");
+                }
+                m_ids[document.key] = id;
+                m_documents.push_back(std::move(document));
+            }
+            auto trigram_count = Toolkit::read_binary<std::uint64_t>(file);
+            m_trigrams.reserve(trigram_count);
+            for (std::uint64_t i = 0; i < trigram_count; i++) {
+                auto key = Toolkit::read_binary<std::uint64_t>(file);
+                auto& ids = m_trigrams[key];
+                ids.resize(Toolkit::read_binary<std::uint32_t>(file));
+                if (not file.read(reinterpret_cast<char*>(ids.data()), static_cast<std::streamsize>(ids.size()*sizeof(std::uint32_t)))) {
+                    throw std::runtime_error("Unexpected end of file");
+                }
+                if (std::any_of(ids.begin(), ids.end(), [&](std::uint32_t id){return id >= document_count;})) {
+                    throw std::runtime_error("invalid song id");
+                }
+            }
+            // Words are cheap to find again, they are not saved
+            for (std::uint32_t id = 0; id < document_count; id++) {
+                index_words(id);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error while loading data/search_index.bin : " << e.what() << '\n';
+            std::cerr << "Every song will be indexed again" << '\n';
+            m_documents.clear();
+            m_ids.clear();
+            m_trigrams.clear();
+            m_words.clear();
+        }
+    }
+
+    std::uint32_t SongSearchIndex::add(const std::string& key, const FileStamp& stamp, const std::string& title, const std::string& artist) {
+        auto it = m_ids.find(key);
+        if (it != m_ids.end()) {
+            auto& document = m_documents[it->second];
+            if (document.stamp == stamp) {
+                document.used = true;
+                return it->second;
+            }
+            remove(key);
+        }
+        auto id = static_cast<std::uint32_t>(m_documents.size());
+        Document document;
+        document.key = key;
+        document.stamp = stamp;
+        document.text = fold_for_search(title) + U'\n' + fold_for_search(artist);
+        document.used = true;
+        m_documents.push_back(std::move(document));
+        m_ids[key] = id;
+        index_document(id);
+        return id;
+    }
+
+    void SongSearchIndex::remove(const std::string& key) {
+        auto it = m_ids.find(key);
+        if (it == m_ids.end()) {
+            return;
+        }
+        // Ids of dead songs are left in the trigram lists and filtered out when searching,
+        // they disappear on the next save
+        m_documents[it->second].alive = false;
+        m_ids.erase(it);
+    }
+
+    void SongSearchIndex::remove_unused() {
+        for (const auto& document : m_documents) {
+            if (document.alive and not document.used) {
+                // copy since remove erases the map entry
+                remove(std::string{document.key});
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> SongSearchIndex::search(std::string_view query) const {
+        auto folded_query = fold_for_search(query);
+        std::vector<std::uint32_t> candidates;
+        if (folded_query.empty()) {
+            return candidates;
+        }
+        if (folded_query.size() >= 3) {
+            std::vector<const std::vector<std::uint32_t>*> lists;
+            for (const auto& key : unique_trigrams(folded_query)) {
+                auto it = m_trigrams.find(key);
+                if (it == m_trigrams.end()) {
+                    return {};
+                }
+                lists.push_back(&it->second);
+            }
+            // Start from the rarest trigram to keep the intersections small
+            std::sort(lists.begin(), lists.end(), [](auto a, auto b){return a->size() < b->size();});
+            candidates = *lists.front();
+            std::vector<std::uint32_t> intersection;
+            for (auto list = std::next(lists.begin()); list != lists.end() and not candidates.empty(); ++list) {
+                intersection.clear();
+                std::set_intersection(
+                    candidates.begin(), candidates.end(),
+                    (*list)->begin(), (*list)->end(),
+                    std::back_inserter(intersection)
+                );
+                candidates.swap(intersection);
+            }
+        } else if (std::any_of(folded_query.begin(), folded_query.end(), [](char32_t c){return c > 0x7F;})) {
+            // Words are only split on ascii separators, so 東方 in the middle of a title is not the start of a word :
+            // short non-ascii queries look at every document, the check below keeps those that contain it
+            candidates.resize(m_documents.size());
+            std::iota(candidates.begin(), candidates.end(), 0);
+        } else {
+            for (
+                auto it = m_words.lower_bound({folded_query, 0});
+                it != m_words.end() and it->first.compare(0, folded_query.size(), folded_query) == 0;
+                ++it
+            ) {
+                candidates.push_back(it->second);
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        }
+        // Having all the trigrams does not mean having them in the right order
+        candidates.erase(
+            std::remove_if(
+                candidates.begin(),
+                candidates.end(),
+                [&](std::uint32_t id){
+                    const auto& document = m_documents[id];
+                    return not document.alive or document.text.find(folded_query) == std::u32string::npos;
+                }
+            ),
+            candidates.end()
+        );
+        return candidates;
+    }
+
+    void SongSearchIndex::index_document(std::uint32_t id) {
+        for (const auto& key : unique_trigrams(m_documents[id].text)) {
+            m_trigrams[key].push_back(id);
+        }
+        index_words(id);
+    }
+
+    void SongSearchIndex::index_words(std::uint32_t id) {
+        const auto& text = m_documents[id].text;
+        std::size_t word_start = 0;
+        for (std::size_t i = 0; i <= text.size(); i++) {
+            if (i == text.size() or is_word_separator(text[i])) {
+                if (i > word_start) {
+                    m_words.emplace(text.substr(word_start, i - word_start), id);
+                }
+                word_start = i + 1;
+            }
+        }
+    }
+
+    void SongSearchIndex::save() const {
+        auto data_folder = m_index_path.parent_path();
+        if (not fs::exists(data_folder)) {
+            fs::create_directory(data_folder);
+        }
+        if (not fs::is_directory(data_folder)) {
+            std::cerr << "Can't create data folder to save the search index, a file named 'data' exists" << '\n';
+            return;
+        }
+        // Dead songs are dropped and the remaining ones get consecutive ids
+        const auto dead = std::numeric_limits<std::uint32_t>::max();
+        std::vector<std::uint32_t> new_ids(m_documents.size(), dead);
+        std::uint32_t alive_count = 0;
+        for (std::size_t id = 0; id < m_documents.size(); id++) {
+            if (m_documents[id].alive) {
+                new_ids[id] = alive_count++;
+            }
+        }
+        std::ofstream file{m_index_path, std::ios::binary | std::ios::trunc};
+        Toolkit::write_binary_string(file, search_index_magic);
+        Toolkit::write_binary<std::uint32_t>(file, search_index_version);
+        Toolkit::write_binary<std::uint32_t>(file, alive_count);
+        for (const auto& document : m_documents) {
+            if (not document.alive) {
+                continue;
+            }
+            Toolkit::write_binary_string(file, document.key);
+            Toolkit::write_binary<std::int64_t>(file, document.stamp.mtime);
+            Toolkit::write_binary<std::uint64_t>(file, document.stamp.size);
+            Toolkit::write_binary<std::uint32_t>(file, static_cast<std::uint32_t>(document.text.size()));
+            file.write(reinterpret_cast<const char*>(document.text.data()), static_cast<std::streamsize>(document.text.size()*sizeof(char32_t)));
+        }
+        std::vector<std::pair<std::uint64_t, std::vector<std::uint32_t>>> trigrams;
+        for (const auto& [key, ids] : m_trigrams) {
+            std::vector<std::uint32_t> alive_ids;
+            for (const auto& id : ids) {
+                if (new_ids[id] != dead) {
+                    alive_ids.push_back(new_ids[id]);
+                }
+            }
+            if (not alive_ids.empty()) {
+                trigrams.emplace_back(key, std::move(alive_ids));
+            }
+        }
+        Toolkit::write_binary<std::uint64_t>(file, trigrams.size());
+        for (const auto& [key, ids] : trigrams) {
+            Toolkit::write_binary<std::uint64_t>(file, key);
+            Toolkit::write_binary<std::uint32_t>(file, static_cast<std::uint32_t>(ids.size()));
+            file.write(reinterpret_cast<const char*>(ids.data()), static_cast<std::streamsize>(ids.size()*sizeof(std::uint32_t)));
+        }
+        if (not file) {
+            std::cerr << "Error while saving data/search_index.bin" << '\n';
+        }
+    }
+}
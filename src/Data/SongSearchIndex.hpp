@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ghc/filesystem.hpp>
+
+#include "SongIndex.hpp"
+
+namespace fs = ghc::filesystem;
+
+namespace Data {
+
+    // Decodes UTF-8 and folds case so that searches don't care about it,
+    // covers latin, greek, cyrillic and fullwidth letters, katakana is folded to hiragana
+    std::u32string fold_for_search(std::string_view utf8);
+
+    // Full-text search over song titles and artists
+    // Queries of three characters or more go through a trigram index,
+    // shorter ascii ones are matched against the start of every word,
+    // shorter ones with other characters (CJK mostly) are searched for in every song
+    // The index is saved in data/search_index.bin so songs that did not change
+    // don't have to be indexed again on the next boot
+    class SongSearchIndex {
+    public:
+        explicit SongSearchIndex(const fs::path& jujube_path);
+        // Returns the id of the song, it is only indexed again if its stamp changed
+        std::uint32_t add(const std::string& key, const FileStamp& stamp, const std::string& title, const std::string& artist);
+        void remove(const std::string& key);
+        // Forgets the songs loaded from disk that were not added since
+        void remove_unused();
+        // Ids of the songs whose title or artist contains the query, in increasing order
+        std::vector<std::uint32_t> search(std::string_view query) const;
+        void save() const;
+    private:
+        struct Document {
+            std::string key;
+            FileStamp stamp;
+            std::u32string text;
+            bool alive = true;
+            bool used = false;
+        };
+        void index_document(std::uint32_t id);
+        void index_words(std::uint32_t id);
+
+        fs::path m_index_path;
+        std::vector<Document> m_documents;
+        std::unordered_map<std::string, std::uint32_t> m_ids;
+        // sorted since ids only ever grow
+        std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_trigrams;
+        std::set<std::pair<std::u32string, std::uint32_t>> m_words;
+    };
+}
@@ -77,9 +77,8 @@ namespace Drawables {
         );
         std::size_t column = 0;
         sf::Vector2f origin{0.f, 39.f};
-        std::vector<std::size_t> index_of_first_vertex_of_each_column;
         for (auto &&colored_density : m_densities) {
-            index_of_first_vertex_of_each_column.push_back(m_vertex_array.size());
+            colored_density.first_vertex = m_vertex_array.size();
             for (size_t row = 0; row < static_cast<std::size_t>(colored_density.density); row++) {
                 m_vertex_array.emplace_back(
                     origin+sf::Vector2f(column*5.0f, row*-5.0f),
@@ -100,15 +99,38 @@ namespace Drawables {
             }
             column++;
         }
-        auto it = m_vertex_array.begin();
-        for (size_t i = 0; i < index_of_first_vertex_of_each_column.size(); i++) {
-            m_densities.at(i).first_vertex = std::next(it, index_of_first_vertex_of_each_column.at(i));
+        upload_all();
+    }
+
+    GradedDensityGraph::GradedDensityGraph(const GradedDensityGraph& other) :
+        sf::Drawable(other),
+        sf::Transformable(other),
+        Toolkit::Debuggable(other),
+        m_densities(other.m_densities),
+        m_vertex_array(other.m_vertex_array),
+        m_seconds_to_column(other.m_seconds_to_column),
+        m_finalized_columns(other.m_finalized_columns),
+        m_dirty_columns(other.m_dirty_columns)
+    {
+        upload_all();
+    }
+
+    void GradedDensityGraph::upload_all() {
+        if (m_vertex_array.empty() or not sf::VertexBuffer::isAvailable()) {
+            return;
+        }
+        if (m_vertex_buffer.create(m_vertex_array.size())) {
+            m_vertex_buffer.update(m_vertex_array.data());
         }
     }
 
     void GradedDensityGraph::draw(sf::RenderTarget& target, sf::RenderStates states) const {
         states.transform *= getTransform();
-        target.draw(&m_vertex_array[0], m_vertex_array.size(), sf::Quads, states);
+        if (m_vertex_buffer.getVertexCount() == m_vertex_array.size() and not m_vertex_array.empty()) {
+            target.draw(m_vertex_buffer, states);
+        } else if (not m_vertex_array.empty()) {
+            target.draw(m_vertex_array.data(), m_vertex_array.size(), sf::Quads, states);
+        }
         if (debug) {
             draw_debug();
         }
@@ -116,28 +138,57 @@ namespace Drawables {
 
     void GradedDensityGraph::update(const sf::Time& music_time) {
         const auto float_column = m_seconds_to_column.transform(music_time.asSeconds());
-        const auto current_column = static_cast<std::size_t>(float_column);
-        const auto current_column_it = std::next(m_densities.begin(), current_column);
-        for (auto it = m_densities.begin(); it != current_column_it and it != m_densities.end(); ++it) {
-            auto color = grade_to_color(it->grade);
-            auto next = std::next(it);
-            std::vector<sf::Vertex>::iterator next_vertex_it;
-            if (next == m_densities.end()) {
-                next_vertex_it = m_vertex_array.end();
-            } else {
-                next_vertex_it = next->first_vertex;
+        const auto current_column = std::min(
+            m_densities.size(),
+            static_cast<std::size_t>(std::max(0.f, float_column))
+        );
+        if (current_column <= m_finalized_columns and m_dirty_columns.none()) {
+            return;
+        }
+        // vertex range that has to be sent to the GPU
+        auto first_changed = m_vertex_array.size();
+        std::size_t last_changed = 0;
+        auto recolor = [&](std::size_t column) {
+            const auto& graded_density = m_densities[column];
+            const auto begin = graded_density.first_vertex;
+            const auto end = begin + 4 * graded_density.density;
+            const auto color = grade_to_color(graded_density.grade);
+            for (auto vertex = begin; vertex < end; vertex++) {
+                m_vertex_array[vertex].color = color;
+            }
+            if (begin < end) {
+                first_changed = std::min(first_changed, begin);
+                last_changed = std::max(last_changed, end);
             }
-            for (auto vertex_it = it->first_vertex; vertex_it != next->first_vertex; ++vertex_it) {
-                vertex_it->color = color;
+        };
+        for (std::size_t column = 0; column < m_finalized_columns; column++) {
+            if (m_dirty_columns.test(column)) {
+                recolor(column);
             }
         }
+        m_dirty_columns.reset();
+        for (auto column = m_finalized_columns; column < current_column; column++) {
+            recolor(column);
+        }
+        m_finalized_columns = std::max(m_finalized_columns, current_column);
+        if (first_changed < last_changed and m_vertex_buffer.getVertexCount() == m_vertex_array.size()) {
+            m_vertex_buffer.update(
+                &m_vertex_array[first_changed],
+                last_changed - first_changed,
+                static_cast<unsigned int>(first_changed)
+            );
+        }
     }
 
     void GradedDensityGraph::update_grades(const Data::Judgement& judge, const sf::Time& timing) {
         const auto float_column = m_seconds_to_column.transform(timing.asSeconds());
         const auto column = static_cast<std::size_t>(float_column);
         auto& current_grade = m_densities.at(column).grade;
-        current_grade = merge_grades(current_grade, judgement_to_density_line_grade(judge));
+        const auto new_grade = merge_grades(current_grade, judgement_to_density_line_grade(judge));
+        if (new_grade != current_grade and column < m_finalized_columns) {
+            m_dirty_columns.set(column);
+        }
+        current_grade = new_grade;
     }
 
     sf::FloatRect GradedDensityGraph::getLocalBounds() const {
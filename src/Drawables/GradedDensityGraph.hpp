@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <bitset>
+#include <cstddef>
 #include <vector>
 
 #include <SFML/Graphics.hpp>
@@ -31,8 +33,8 @@ namespace Drawables {
         
         DensityLineGrade grade = DensityLineGrade::NonGraded;
         unsigned int density = 0;
-        // iterator to the first vertex of the corresponding column
-        std::vector<sf::Vertex>::iterator first_vertex;
+        // index of the first vertex of the corresponding column, each row is a quad
+        std::size_t first_vertex = 0;
     };
 
     // helper function for GradedDensityGraph
@@ -41,9 +43,13 @@ namespace Drawables {
     class GradedDensityGraph : public sf::Drawable, public sf::Transformable, public Toolkit::Debuggable {
     public:
         GradedDensityGraph(const DensityGraph& density_graph, const Data::SongDifficulty& sd);
-        // Set verticies colors for density columns that have already been played
+        // The vertex buffer is uploaded again from the copied vertices
+        GradedDensityGraph(const GradedDensityGraph& other);
+        GradedDensityGraph& operator=(const GradedDensityGraph&) = delete;
+        // Set verticies colors for density columns that were just played or graded again,
+        // only the vertices that changed are sent to the GPU
         void update(const sf::Time& music_time);
-        // Update stored grades according to the recieved judgement
+        // Update stored grades according to the recieved judgement, marks the column dirty if it is already colored
         void update_grades(const Data::Judgement& judge, const sf::Time& timing);
         sf::FloatRect getLocalBounds() const;
         sf::FloatRect getGlobalBounds() const;
@@ -51,8 +57,16 @@ namespace Drawables {
         void draw_debug() const;
     private:
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+        void upload_all();
+
         std::array<GradedDensity, 115> m_densities;
         std::vector<sf::Vertex> m_vertex_array;
+        // copy of m_vertex_array on the GPU, not created if vertex buffers are unavailable
+        sf::VertexBuffer m_vertex_buffer{sf::Quads, sf::VertexBuffer::Dynamic};
         Toolkit::AffineTransform<float> m_seconds_to_column;
+        // columns before this one have been colored with their grade
+        std::size_t m_finalized_columns = 0;
+        // finalized columns whose grade changed since they were colored
+        std::bitset<115> m_dirty_columns;
     };
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "HUDText.hpp"
+
+namespace Drawables {
+    HUDText::HUDText(const sf::Font& font) {
+        m_text.setFont(font);
+    }
+
+    void HUDText::set_string(const std::string& utf8) {
+        if (utf8 == m_utf8 and not m_number) {
+            return;
+        }
+        m_utf8 = utf8;
+        m_number.reset();
+        m_text.setString(sf::String::fromUtf8(utf8.begin(), utf8.end()));
+        update_origin();
+    }
+
+    void HUDText::set_number(long long number) {
+        if (m_number == number) {
+            return;
+        }
+        m_number = number;
+        m_utf8.clear();
+        m_text.setString(std::to_string(number));
+        update_origin();
+    }
+
+    void HUDText::set_character_size(unsigned int size) {
+        if (size == m_text.getCharacterSize()) {
+            return;
+        }
+        m_text.setCharacterSize(size);
+        update_origin();
+    }
+
+    void HUDText::set_style(sf::Uint32 style) {
+        if (style == m_text.getStyle()) {
+            return;
+        }
+        m_text.setStyle(style);
+        update_origin();
+    }
+
+    void HUDText::set_origin_normalized(float x, float y) {
+        m_normalized_origin = {x, y};
+        m_origin_includes_bounds_position = true;
+        update_origin();
+    }
+
+    void HUDText::set_origin_normalized_no_position(float x, float y) {
+        m_normalized_origin = {x, y};
+        m_origin_includes_bounds_position = false;
+        update_origin();
+    }
+
+    sf::FloatRect HUDText::get_local_bounds() const {
+        return m_text.getLocalBounds();
+    }
+
+    void HUDText::update_origin() {
+        auto bounds = m_text.getLocalBounds();
+        if (m_origin_includes_bounds_position) {
+            m_text.setOrigin(
+                bounds.left+m_normalized_origin.x*bounds.width,
+                bounds.top+m_normalized_origin.y*bounds.height
+            );
+        } else {
+            m_text.setOrigin(m_normalized_origin.x*bounds.width, m_normalized_origin.y*bounds.height);
+        }
+    }
+
+    void HUDText::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+        states.transform *= getTransform();
+        target.draw(m_text, states);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <SFML/Graphics.hpp>
+
+namespace Drawables {
+    // sf::Text meant to be kept around between frames : setting the same string, number, size or style
+    // again is a no-op, so the glyph geometry and the origin are only computed again when something changed
+    class HUDText : public sf::Drawable, public sf::Transformable {
+    public:
+        explicit HUDText(const sf::Font& font);
+        // Converted from utf-8 only if it differs from the last one
+        void set_string(const std::string& utf8);
+        void set_number(long long number);
+        void set_character_size(unsigned int size);
+        void set_style(sf::Uint32 style);
+        void set_fill_color(const sf::Color& color) {m_text.setFillColor(color);};
+        // Same meaning as Toolkit::set_local_origin_normalized, kept when the text changes
+        void set_origin_normalized(float x, float y);
+        // Same meaning as Toolkit::set_origin_normalized_no_position, kept when the text changes
+        void set_origin_normalized_no_position(float x, float y);
+        sf::FloatRect get_local_bounds() const;
+        bool empty() const {return m_text.getString().isEmpty();};
+    private:
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+        void update_origin();
+
+        sf::Text m_text;
+        std::string m_utf8;
+        std::optional<long long> m_number;
+        sf::Vector2f m_normalized_origin = {0.f, 0.f};
+        bool m_origin_includes_bounds_position = true;
+    };
+}
@@ -0,0 +1,272 @@
+#include "EvdevInput.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <ghc/filesystem.hpp>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <linux/input.h>
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+namespace fs = ghc::filesystem;
+
+namespace Input {
+    std::int64_t monotonic_now_us() {
+        // steady_clock is CLOCK_MONOTONIC on Linux
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    }
+
+    #ifdef __linux__
+        namespace {
+            // evdev codes are physical positions, they are translated as if the keyboard had a US layout
+            std::optional<sf::Keyboard::Key> evdev_to_sfml(unsigned short code) {
+                switch (code) {
+                    case KEY_A: return sf::Keyboard::A;
+                    case KEY_B: return sf::Keyboard::B;
+                    case KEY_C: return sf::Keyboard::C;
+                    case KEY_D: return sf::Keyboard::D;
+                    case KEY_E: return sf::Keyboard::E;
+                    case KEY_F: return sf::Keyboard::F;
+                    case KEY_G: return sf::Keyboard::G;
+                    case KEY_H: return sf::Keyboard::H;
+                    case KEY_I: return sf::Keyboard::I;
+                    case KEY_J: return sf::Keyboard::J;
+                    case KEY_K: return sf::Keyboard::K;
+                    case KEY_L: return sf::Keyboard::L;
+                    case KEY_M: return sf::Keyboard::M;
+                    case KEY_N: return sf::Keyboard::N;
+                    case KEY_O: return sf::Keyboard::O;
+                    case KEY_P: return sf::Keyboard::P;
+                    case KEY_Q: return sf::Keyboard::Q;
+                    case KEY_R: return sf::Keyboard::R;
+                    case KEY_S: return sf::Keyboard::S;
+                    case KEY_T: return sf::Keyboard::T;
+                    case KEY_U: return sf::Keyboard::U;
+                    case KEY_V: return sf::Keyboard::V;
+                    case KEY_W: return sf::Keyboard::W;
+                    case KEY_X: return sf::Keyboard::X;
+                    case KEY_Y: return sf::Keyboard::Y;
+                    case KEY_Z: return sf::Keyboard::Z;
+                    case KEY_0: return sf::Keyboard::Num0;
+                    case KEY_1: return sf::Keyboard::Num1;
+                    case KEY_2: return sf::Keyboard::Num2;
+                    case KEY_3: return sf::Keyboard::Num3;
+                    case KEY_4: return sf::Keyboard::Num4;
+                    case KEY_5: return sf::Keyboard::Num5;
+                    case KEY_6: return sf::Keyboard::Num6;
+                    case KEY_7: return sf::Keyboard::Num7;
+                    case KEY_8: return sf::Keyboard::Num8;
+                    case KEY_9: return sf::Keyboard::Num9;
+                    case KEY_ESC: return sf::Keyboard::Escape;
+                    case KEY_LEFTCTRL: return sf::Keyboard::LControl;
+                    case KEY_LEFTSHIFT: return sf::Keyboard::LShift;
+                    case KEY_LEFTALT: return sf::Keyboard::LAlt;
+                    case KEY_LEFTMETA: return sf::Keyboard::LSystem;
+                    case KEY_RIGHTCTRL: return sf::Keyboard::RControl;
+                    case KEY_RIGHTSHIFT: return sf::Keyboard::RShift;
+                    case KEY_RIGHTALT: return sf::Keyboard::RAlt;
+                    case KEY_RIGHTMETA: return sf::Keyboard::RSystem;
+                    case KEY_COMPOSE: return sf::Keyboard::Menu;
+                    case KEY_LEFTBRACE: return sf::Keyboard::LBracket;
+                    case KEY_RIGHTBRACE: return sf::Keyboard::RBracket;
+                    case KEY_SEMICOLON: return sf::Keyboard::Semicolon;
+                    case KEY_COMMA: return sf::Keyboard::Comma;
+                    case KEY_DOT: return sf::Keyboard::Period;
+                    case KEY_APOSTROPHE: return sf::Keyboard::Quote;
+                    case KEY_SLASH: return sf::Keyboard::Slash;
+                    case KEY_BACKSLASH: return sf::Keyboard::Backslash;
+                    case KEY_GRAVE: return sf::Keyboard::Tilde;
+                    case KEY_EQUAL: return sf::Keyboard::Equal;
+                    case KEY_MINUS: return sf::Keyboard::Hyphen;
+                    case KEY_SPACE: return sf::Keyboard::Space;
+                    case KEY_ENTER: return sf::Keyboard::Enter;
+                    case KEY_BACKSPACE: return sf::Keyboard::Backspace;
+                    case KEY_TAB: return sf::Keyboard::Tab;
+                    case KEY_PAGEUP: return sf::Keyboard::PageUp;
+                    case KEY_PAGEDOWN: return sf::Keyboard::PageDown;
+                    case KEY_END: return sf::Keyboard::End;
+                    case KEY_HOME: return sf::Keyboard::Home;
+                    case KEY_INSERT: return sf::Keyboard::Insert;
+                    case KEY_DELETE: return sf::Keyboard::Delete;
+                    case KEY_KPPLUS: return sf::Keyboard::Add;
+                    case KEY_KPMINUS: return sf::Keyboard::Subtract;
+                    case KEY_KPASTERISK: return sf::Keyboard::Multiply;
+                    case KEY_KPSLASH: return sf::Keyboard::Divide;
+                    case KEY_LEFT: return sf::Keyboard::Left;
+                    case KEY_RIGHT: return sf::Keyboard::Right;
+                    case KEY_UP: return sf::Keyboard::Up;
+                    case KEY_DOWN: return sf::Keyboard::Down;
+                    case KEY_KP0: return sf::Keyboard::Numpad0;
+                    case KEY_KP1: return sf::Keyboard::Numpad1;
+                    case KEY_KP2: return sf::Keyboard::Numpad2;
+                    case KEY_KP3: return sf::Keyboard::Numpad3;
+                    case KEY_KP4: return sf::Keyboard::Numpad4;
+                    case KEY_KP5: return sf::Keyboard::Numpad5;
+                    case KEY_KP6: return sf::Keyboard::Numpad6;
+                    case KEY_KP7: return sf::Keyboard::Numpad7;
+                    case KEY_KP8: return sf::Keyboard::Numpad8;
+                    case KEY_KP9: return sf::Keyboard::Numpad9;
+                    case KEY_F1: return sf::Keyboard::F1;
+                    case KEY_F2: return sf::Keyboard::F2;
+                    case KEY_F3: return sf::Keyboard::F3;
+                    case KEY_F4: return sf::Keyboard::F4;
+                    case KEY_F5: return sf::Keyboard::F5;
+                    case KEY_F6: return sf::Keyboard::F6;
+                    case KEY_F7: return sf::Keyboard::F7;
+                    case KEY_F8: return sf::Keyboard::F8;
+                    case KEY_F9: return sf::Keyboard::F9;
+                    case KEY_F10: return sf::Keyboard::F10;
+                    case KEY_F11: return sf::Keyboard::F11;
+                    case KEY_F12: return sf::Keyboard::F12;
+                    case KEY_F13: return sf::Keyboard::F13;
+                    case KEY_F14: return sf::Keyboard::F14;
+                    case KEY_F15: return sf::Keyboard::F15;
+                    case KEY_PAUSE: return sf::Keyboard::Pause;
+                    default: return {};
+                }
+            }
+
+            bool has_bit(const unsigned long* bits, unsigned int bit) {
+                const auto bits_per_long = 8 * sizeof(unsigned long);
+                return (bits[bit / bits_per_long] >> (bit % bits_per_long)) & 1UL;
+            }
+
+            // Mice and gamepads also report EV_KEY, only keep what has letter keys
+            bool is_keyboard(int fd) {
+                unsigned long key_bits[(KEY_MAX + 1) / (8 * sizeof(unsigned long)) + 1] = {};
+                if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(key_bits)), key_bits) < 0) {
+                    return false;
+                }
+                return has_bit(key_bits, KEY_A) and has_bit(key_bits, KEY_Z);
+            }
+        }
+
+        EvdevInput::EvdevInput() {
+            std::error_code ec;
+            for (const auto& dir_item : fs::directory_iterator("/dev/input", ec)) {
+                if (dir_item.path().filename().string().rfind("event", 0) != 0) {
+                    continue;
+                }
+                int fd = open(dir_item.path().c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+                if (fd == -1) {
+                    continue;
+                }
+                int clock = CLOCK_MONOTONIC;
+                if (not is_keyboard(fd) or ioctl(fd, EVIOCSCLOCKID, &clock) < 0) {
+                    close(fd);
+                    continue;
+                }
+                device_fds.push_back(fd);
+            }
+            if (device_fds.empty()) {
+                std::cerr << "evdev input : could not open any keyboard in /dev/input, falling back to window events" << '\n';
+                return;
+            }
+            stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (stop_fd == -1) {
+                std::cerr << "evdev input : could not create the stop eventfd, falling back to window events" << '\n';
+                return;
+            }
+            std::cout << "evdev input : reading from " << device_fds.size() << " keyboards" << '\n';
+            reading = true;
+            reading_thread = std::thread{&EvdevInput::read_loop, this};
+        }
+
+        EvdevInput::~EvdevInput() {
+            if (reading_thread.joinable()) {
+                std::uint64_t one = 1;
+                [[maybe_unused]] auto written = write(stop_fd, &one, sizeof(one));
+                reading_thread.join();
+            }
+            for (const auto& fd : device_fds) {
+                close(fd);
+            }
+            if (stop_fd != -1) {
+                close(stop_fd);
+            }
+        }
+
+        void EvdevInput::read_loop() {
+            // whatever way the loop ends, keys have to go back to window events
+            struct StopReading {
+                std::atomic<bool>& reading;
+                ~StopReading() {reading = false;}
+            } stop_reading{reading};
+            std::vector<pollfd> fds;
+            for (const auto& fd : device_fds) {
+                fds.push_back({fd, POLLIN, 0});
+            }
+            fds.push_back({stop_fd, POLLIN, 0});
+            while (true) {
+                if (poll(fds.data(), fds.size(), -1) == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    std::cerr << "evdev input : poll failed (" << std::strerror(errno) << "), stopped reading keyboards" << '\n';
+                    return;
+                }
+                if (fds.back().revents != 0) {
+                    return;
+                }
+                // backwards so unplugged devices can be removed on the way
+                for (std::size_t i = fds.size() - 1; i-- > 0;) {
+                    if (fds[i].revents & POLLIN) {
+                        read_events(fds[i].fd);
+                    }
+                    // an unplugged keyboard reports errors forever and would make poll() return right away
+                    if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                        std::cerr << "evdev input : lost a keyboard, " << fds.size() - 2 << " left" << '\n';
+                        close(fds[i].fd);
+                        device_fds.erase(std::find(device_fds.begin(), device_fds.end(), fds[i].fd));
+                        fds.erase(fds.begin() + static_cast<std::ptrdiff_t>(i));
+                    }
+                }
+                if (fds.size() == 1) {
+                    std::cerr << "evdev input : no keyboard left, falling back to window events" << '\n';
+                    return;
+                }
+            }
+        }
+
+        void EvdevInput::read_events(int fd) {
+            input_event buffer[64];
+            auto length = read(fd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                return;
+            }
+            auto count = static_cast<std::size_t>(length) / sizeof(input_event);
+            for (std::size_t e = 0; e < count; e++) {
+                const auto& event = buffer[e];
+                // value is 0 for release, 1 for press and 2 for autorepeat
+                if (event.type != EV_KEY or event.value == 2) {
+                    continue;
+                }
+                auto key = evdev_to_sfml(event.code);
+                if (not key) {
+                    continue;
+                }
+                events.push({
+                    *key,
+                    event.value == 1 ? EventType::Pressed : EventType::Released,
+                    static_cast<std::int64_t>(event.input_event_sec) * 1000000 + event.input_event_usec
+                });
+            }
+        }
+    #else
+        EvdevInput::EvdevInput() {
+            std::cerr << "evdev input is only available on Linux, falling back to window events" << '\n';
+        }
+
+        EvdevInput::~EvdevInput() = default;
+    #endif
+}
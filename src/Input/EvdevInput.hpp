@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <SFML/Window/Keyboard.hpp>
+
+#include "../Toolkit/SPSCRingBuffer.hpp"
+#include "Events.hpp"
+
+namespace Input {
+    struct TimestampedKeyEvent {
+        sf::Keyboard::Key key;
+        EventType type;
+        // CLOCK_MONOTONIC time at which the kernel saw the key change, in microseconds
+        std::int64_t timestamp_us;
+    };
+
+    // Current time in microseconds on the same clock as the event timestamps
+    std::int64_t monotonic_now_us();
+
+    // Reads keyboards straight from /dev/input/event* on a thread of its own,
+    // events keep the timestamp the kernel gave them instead of the time they were polled at.
+    // Only implemented on Linux, and the user needs read access to the devices
+    // (usually by being in the input group), otherwise is_running() is false.
+    // is_running() also turns false if reading stops later on (poll error, every keyboard unplugged)
+    class EvdevInput {
+    public:
+        EvdevInput();
+        ~EvdevInput();
+        EvdevInput(const EvdevInput&) = delete;
+        EvdevInput& operator=(const EvdevInput&) = delete;
+
+        bool is_running() const {return reading;};
+        // To be called from a single thread
+        std::optional<TimestampedKeyEvent> pop() {return events.pop();};
+    private:
+        void read_loop();
+        // Reads what's pending on a device and pushes the key events
+        void read_events(int fd);
+
+        std::vector<int> device_fds;
+        // written to in the destructor to wake the reading thread up
+        int stop_fd = -1;
+        Toolkit::SPSCRingBuffer<TimestampedKeyEvent, 1024> events;
+        // true while the reading thread is polling at least one keyboard
+        std::atomic<bool> reading = false;
+        std::thread reading_thread;
+    };
+}
@@ -1,4 +1,11 @@
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 
 #include <imgui-sfml/imgui-SFML.h>
 #include <SFML/Graphics.hpp>
@@ -6,6 +13,7 @@
 
 #include "Data/Song.hpp"
 #include "Data/Preferences.hpp"
+#include "Data/Replay.hpp"
 #include "Drawables/GradedDensityGraph.hpp"
 #include "Resources/Marker.hpp"
 #include "Resources/SharedResources.hpp"
@@ -21,18 +29,138 @@
     #include <X11/Xlib.h>
 #endif
 
-int main(int, char const **) {
+// Plays back a replay saved in data/replays, then shows its results
+int play_replay(
+    const ghc::filesystem::path& replay_path,
+    const ghc::filesystem::path& jujube_path,
+    sf::RenderWindow& window,
+    Gameplay::ScreenResources& gameplay_resources,
+    Results::ScreenResources& results_resources
+) {
+    try {
+        auto replay = Data::Replay::load(replay_path);
+        std::optional<ghc::filesystem::path> memon_path;
+        for (const auto& entry : ghc::filesystem::directory_iterator(replay.song_folder)) {
+            if (entry.path().extension() == ".memon") {
+                memon_path = entry.path();
+                break;
+            }
+        }
+        if (not memon_path) {
+            throw std::runtime_error("No memon file in "+replay.song_folder.string());
+        }
+        Data::MemonSong song{*memon_path, jujube_path/"data"/"charts"};
+        if (song.chart_levels.find(replay.difficulty) == song.chart_levels.end()) {
+            throw std::runtime_error(song.title+" has no "+replay.difficulty+" chart");
+        }
+        const auto difficulty = replay.difficulty;
+        Data::SongDifficulty chart{song, difficulty};
+        std::cout << "Playing back a replay of " << song.title << " [" << difficulty << "]" << '\n';
+        auto prepared_chart = gameplay_resources.shared.chart_preparation.take(chart);
+        Gameplay::Screen gameplay{chart, std::move(prepared_chart), gameplay_resources, std::move(replay)};
+        auto detailed_score = gameplay.play_chart(window);
+        Results::Screen result_screen{detailed_score.gdg, chart, detailed_score.score, results_resources};
+        result_screen.display(window);
+    } catch (const std::exception& e) {
+        std::cerr << "Could not play back " << replay_path << " : " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+// Everything the screens share, slow to build because of all the marker textures
+struct LoadedResources {
+    explicit LoadedResources(Data::Preferences& preferences) :
+        shared(preferences),
+        music_select(shared)
+    {}
+    Resources::SharedResources shared;
+    MusicSelect::ScreenResources music_select;
+};
+
+// Builds the resources on another thread, the window keeps drawing a loading
+// message and handling events meanwhile so it does not look frozen.
+// Returns nothing if the window got closed in the meantime
+std::unique_ptr<LoadedResources> load_resources(sf::RenderWindow& window, Data::Preferences& preferences, sf::Clock& startup_clock) {
+    sf::Font font;
+    const auto font_path = preferences.jujube_path/"assets"/"fonts"/"M_PLUS_Rounded_1c"/"MPLUSRounded1c-Light.ttf";
+    if (not font.loadFromFile(font_path)) {
+        throw std::runtime_error("Unable to load "+font_path.string());
+    }
+    sf::Text loading_text{"Loading ...", font};
+    auto loading = std::async(std::launch::async, [&](){return std::make_unique<LoadedResources>(preferences);});
+    bool first_frame = true;
+    sf::Clock frame_clock;
+    sf::Time longest_frame = sf::Time::Zero;
+    while (loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+            } else if (event.type == sf::Event::Resized) {
+                window.setView(sf::View{sf::FloatRect{0, 0, static_cast<float>(event.size.width), static_cast<float>(event.size.height)}});
+            }
+        }
+        // get() below waits for the loading to finish anyway
+        if (not window.isOpen()) {
+            break;
+        }
+        const auto window_size = sf::Vector2f{window.getView().getSize()};
+        loading_text.setCharacterSize(static_cast<unsigned int>(std::max(12.f, window_size.y / 20.f)));
+        const auto bounds = loading_text.getLocalBounds();
+        loading_text.setOrigin(bounds.left + bounds.width, bounds.top + bounds.height);
+        loading_text.setPosition(window_size.x * 0.95f, window_size.y * 0.95f);
+        window.clear(sf::Color(7, 23, 53));
+        window.draw(loading_text);
+        window.display();
+        if (first_frame) {
+            std::cout << "Time to first frame : " << startup_clock.getElapsedTime().asMilliseconds() << "ms" << '\n';
+            first_frame = false;
+        } else {
+            longest_frame = std::max(longest_frame, frame_clock.getElapsedTime());
+        }
+        frame_clock.restart();
+    }
+    auto resources = loading.get();
+    std::cout << "Resources loaded after " << startup_clock.getElapsedTime().asMilliseconds() << "ms, ";
+    std::cout << "longest loading frame : " << longest_frame.asMilliseconds() << "ms" << '\n';
+    if (not window.isOpen()) {
+        return {};
+    }
+    return resources;
+}
+
+int main(int argc, char const ** argv) {
 
     #if defined(__unix__) && defined(__linux__)
         XInitThreads();
     #endif
 
-    // Load prefs, music, markers
+    sf::Clock startup_clock;
     const std::string jujube_path = whereami::executable_dir();
     Data::Preferences preferences{jujube_path};
+
+    // Create the window first so there's something on screen while everything else loads
+    sf::ContextSettings settings;
+    settings.antialiasingLevel = 8;
+    sf::RenderWindow window{
+        preferences.screen.video_mode,
+        "jujube",
+        preferences.screen.style == Data::DisplayStyle::Windowed ? sf::Style::Default : sf::Style::Fullscreen,
+        settings
+    };
+    window.setFramerateLimit(60);
+    ImGui::SFML::Init(window);
+
+    // Songs keep loading in the background, they show up on the music select screen as they are found
     Data::SongList song_list{jujube_path};
-    Resources::SharedResources shared_resources{preferences};
-    MusicSelect::ScreenResources music_select_resources{shared_resources};
+    auto loaded_resources = load_resources(window, preferences, startup_clock);
+    if (not loaded_resources) {
+        ImGui::SFML::Shutdown();
+        return 0;
+    }
+    auto& shared_resources = loaded_resources->shared;
+    auto& music_select_resources = loaded_resources->music_select;
     if (shared_resources.markers.find(preferences.options.marker) == shared_resources.markers.end()) {
         preferences.options.marker = shared_resources.markers.begin()->first;
     }
@@ -43,18 +171,13 @@ int main(int, char const **) {
     
     Gameplay::ScreenResources gameplay_resources{shared_resources};
     Results::ScreenResources results_resources{shared_resources};
+    std::cout << "Time to music select : " << startup_clock.getElapsedTime().asMilliseconds() << "ms" << '\n';
 
-    // Create the window
-    sf::ContextSettings settings;
-    settings.antialiasingLevel = 8;
-    sf::RenderWindow window{
-        preferences.screen.video_mode,
-        "jujube",
-        preferences.screen.style == Data::DisplayStyle::Windowed ? sf::Style::Default : sf::Style::Fullscreen,
-        settings
-    };
-    window.setFramerateLimit(60);
-    ImGui::SFML::Init(window);
+    if (argc == 3 and std::string(argv[1]) == "--replay") {
+        auto status = play_replay(argv[2], jujube_path, window, gameplay_resources, results_resources);
+        ImGui::SFML::Shutdown();
+        return status;
+    }
 
     while (window.isOpen()) {
         auto chart = music_select.select_chart(window);
@@ -65,7 +188,7 @@ int main(int, char const **) {
             break;
         }
 
-        Gameplay::Screen gameplay{*chart, gameplay_resources};
+        Gameplay::Screen gameplay{*chart, shared_resources.chart_preparation.take(*chart), gameplay_resources};
         auto detailed_score = gameplay.play_chart(window);
         
         Results::Screen result_screen{detailed_score.gdg, *chart, detailed_score.score, results_resources};
@@ -0,0 +1,144 @@
+#include "MarkerAtlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace Resources {
+    namespace {
+        // transparent pixels left between frames so smoothing does not bleed one frame into another
+        const unsigned int gutter = 1;
+    }
+
+    MarkerAtlas::MarkerAtlas(const Marker& marker, const LNMarker& ln_marker) :
+        marker_folder(marker.folder),
+        ln_marker_folder(ln_marker.folder)
+    {
+        build_page(pages[0], {
+            {&marker.approach, marker.size},
+            {&marker.miss, marker.size},
+            {&marker.poor, marker.size},
+            {&marker.good, marker.size},
+            {&marker.great, marker.size},
+            {&marker.perfect, marker.size},
+        });
+        build_page(pages[1], {
+            {&ln_marker.background, ln_marker.size},
+            {&ln_marker.outline, ln_marker.size},
+            {&ln_marker.highlight, ln_marker.size},
+            {&ln_marker.tip_appearance, ln_marker.size},
+            {&ln_marker.tip_enter_cycle, ln_marker.size},
+            {&ln_marker.tip_cycle, ln_marker.size},
+        });
+    }
+
+    void MarkerAtlas::build_page(Page& page, const std::vector<std::pair<const SpriteSheet*, std::size_t>>& to_pack) {
+        // Aim for a roughly square texture
+        std::size_t area = 0;
+        std::size_t largest_frame = 0;
+        for (const auto& [sheet, size] : to_pack) {
+            area += sheet->count * (size + gutter) * (size + gutter);
+            largest_frame = std::max(largest_frame, size + gutter);
+        }
+        const auto max_size = sf::Texture::getMaximumSize();
+        page.width = std::min(
+            max_size,
+            static_cast<unsigned int>(std::max(largest_frame, static_cast<std::size_t>(std::ceil(std::sqrt(area)))))
+        );
+        for (const auto& [sheet, size] : to_pack) {
+            place(page, *sheet, size);
+        }
+        const auto height = page.cursor.y + page.shelf_height;
+        if (height > max_size) {
+            std::cerr << "Marker atlas : " << page.width << "×" << height << " pixels is more than the "
+            << max_size << "×" << max_size << " this GPU allows, markers will use their own sprite sheets" << '\n';
+            page.sheets.clear();
+            return;
+        }
+
+        sf::Image atlas;
+        atlas.create(page.width, height, sf::Color::Transparent);
+        for (const auto& sheet : page.sheets) {
+            const auto source = sheet.source->copyToImage();
+            for (std::size_t frame = 0; frame < sheet.frames.size(); frame++) {
+                const sf::IntRect source_rect{
+                    sf::Vector2i{
+                        static_cast<int>(frame % sheet.columns),
+                        static_cast<int>(frame / sheet.columns)
+                    } * sheet.size,
+                    sf::Vector2i{sheet.size, sheet.size}
+                };
+                atlas.copy(
+                    source,
+                    static_cast<unsigned int>(sheet.frames[frame].left),
+                    static_cast<unsigned int>(sheet.frames[frame].top),
+                    source_rect
+                );
+            }
+        }
+        if (not page.texture.loadFromImage(atlas)) {
+            std::cerr << "Marker atlas : could not upload the texture, markers will use their own sprite sheets" << '\n';
+            page.sheets.clear();
+            return;
+        }
+        page.texture.setSmooth(true);
+    }
+
+    void MarkerAtlas::place(Page& page, const SpriteSheet& sheet, std::size_t size) {
+        PackedSheet packed{&sheet.tex, sheet.columns, static_cast<int>(size), {}};
+        const auto step = static_cast<unsigned int>(size) + gutter;
+        for (std::size_t frame = 0; frame < sheet.count; frame++) {
+            if (page.cursor.x + step > page.width) {
+                page.cursor = {0, page.cursor.y + page.shelf_height};
+                page.shelf_height = 0;
+            }
+            packed.frames.emplace_back(
+                static_cast<int>(page.cursor.x),
+                static_cast<int>(page.cursor.y),
+                static_cast<int>(size),
+                static_cast<int>(size)
+            );
+            page.cursor.x += step;
+            page.shelf_height = std::max(page.shelf_height, step);
+        }
+        page.sheets.push_back(std::move(packed));
+    }
+
+    sf::Sprite MarkerAtlas::remap(const sf::Sprite& sprite) const {
+        for (const auto& page : pages) {
+            const auto sheet = std::find_if(
+                page.sheets.begin(),
+                page.sheets.end(),
+                [&](const PackedSheet& s){return s.source == sprite.getTexture();}
+            );
+            if (sheet == page.sheets.end()) {
+                continue;
+            }
+            const auto rect = sprite.getTextureRect();
+            const auto frame = static_cast<std::size_t>(rect.top / sheet->size) * sheet->columns
+                + static_cast<std::size_t>(rect.left / sheet->size);
+            if (frame >= sheet->frames.size()) {
+                return sprite;
+            }
+            sf::Sprite remapped = sprite;
+            remapped.setTexture(page.texture);
+            remapped.setTextureRect(sheet->frames[frame]);
+            return remapped;
+        }
+        return sprite;
+    }
+
+    bool MarkerAtlas::is_built_from(const Marker& marker, const LNMarker& ln_marker) const {
+        return marker.folder == marker_folder and ln_marker.folder == ln_marker_folder;
+    }
+
+    std::size_t MarkerAtlas::get_frame_count() const {
+        std::size_t count = 0;
+        for (const auto& page : pages) {
+            for (const auto& sheet : page.sheets) {
+                count += sheet.frames.size();
+            }
+        }
+        return count;
+    }
+}
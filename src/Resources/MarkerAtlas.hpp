@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <ghc/filesystem.hpp>
+#include <SFML/Graphics.hpp>
+
+#include "LNMarker.hpp"
+#include "Marker.hpp"
+#include "SpriteSheet.hpp"
+
+namespace fs = ghc::filesystem;
+
+namespace Resources {
+    // Every frame of a tap marker packed in one texture and every frame of a long note marker in another,
+    // so markers in different animation states can be drawn in the same batch.
+    // Two pages instead of one keep each texture under the 4096×4096 of most integrated GPUs.
+    // Long note tails are left out : they are tiled so each frame needs a texture of its own
+    class MarkerAtlas {
+    public:
+        MarkerAtlas(const Marker& marker, const LNMarker& ln_marker);
+        // The same sprite pointing inside the atlas, or unchanged if its texture was not packed
+        sf::Sprite remap(const sf::Sprite& sprite) const;
+        bool is_built_from(const Marker& marker, const LNMarker& ln_marker) const;
+        // 0 for the tap marker, 1 for the long note marker
+        const sf::Texture& get_page(std::size_t page) const {return pages.at(page).texture;};
+        std::size_t get_frame_count() const;
+    private:
+        struct PackedSheet {
+            const sf::Texture* source;
+            std::size_t columns;
+            int size;
+            // frame number in the source sheet -> texture rect in the page
+            std::vector<sf::IntRect> frames;
+        };
+        struct Page {
+            sf::Texture texture;
+            std::vector<PackedSheet> sheets;
+            // packing state
+            unsigned int width = 0;
+            sf::Vector2u cursor = {0, 0};
+            unsigned int shelf_height = 0;
+        };
+        // Packs the sheets in page, it is left empty if they do not fit in a texture
+        static void build_page(Page& page, const std::vector<std::pair<const SpriteSheet*, std::size_t>>& to_pack);
+        // Reserves room for the frames of sheet, shelf by shelf
+        static void place(Page& page, const SpriteSheet& sheet, std::size_t size);
+
+        fs::path marker_folder;
+        fs::path ln_marker_folder;
+        std::array<Page, 2> pages;
+    };
+}
@@ -28,6 +28,7 @@ namespace Resources {
         fallback_font(p.jujube_path),
         black_frame(p),
         button_highlight(p),
+        chart_preparation(p, density_graphs),
         markers(p.jujube_path),
         ln_markers(p.jujube_path)
     {
@@ -58,4 +59,17 @@ namespace Resources {
     Resources::LNMarker& SharedResources::get_selected_ln_marker() {
         return ln_markers.at(preferences.options.ln_marker);
     }
+
+    const Resources::MarkerAtlas& SharedResources::get_selected_marker_atlas() {
+        const auto& marker = get_selected_marker();
+        const auto& ln_marker = get_selected_ln_marker();
+        if (not marker_atlas or not marker_atlas->is_built_from(marker, ln_marker)) {
+            marker_atlas.emplace(marker, ln_marker);
+            std::cout << "Packed " << marker_atlas->get_frame_count() << " marker frames in a "
+            << marker_atlas->get_page(0).getSize().x << "×" << marker_atlas->get_page(0).getSize().y << " and a "
+            << marker_atlas->get_page(1).getSize().x << "×" << marker_atlas->get_page(1).getSize().y
+            << " atlas" << '\n';
+        }
+        return *marker_atlas;
+    }
 }
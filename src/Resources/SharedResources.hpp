@@ -16,7 +16,9 @@
 #include "../Drawables/DensityGraph.hpp"
 #include "../Resources/Marker.hpp"
 #include "../Resources/LNMarker.hpp"
+#include "../Resources/MarkerAtlas.hpp"
 #include "../Resources/TextureCache.hpp"
+#include "../Screens/Gameplay/ChartPreparation.hpp"
 
 namespace Resources {
 
@@ -50,6 +52,8 @@ namespace Resources {
         Drawables::ButtonHighlight button_highlight;
         
         Drawables::DensityGraphCache density_graphs;
+        // Started by the music select screen as soon as a chart is selected
+        Gameplay::ChartPreparation chart_preparation;
 
         sf::Color BSC_color = sf::Color{34,216,92};
         sf::Color ADV_color = sf::Color{252,212,32};
@@ -61,6 +65,11 @@ namespace Resources {
 
         Resources::LNMarkers ln_markers;
         Resources::LNMarker& get_selected_ln_marker();
+
+        // Built again only when the selected markers changed
+        const Resources::MarkerAtlas& get_selected_marker_atlas();
+    private:
+        std::optional<Resources::MarkerAtlas> marker_atlas;
     };
 
     // Proxy for HoldsPreferences
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <optional>
+
 #include <SFML/Audio/SoundSource.hpp>
 #include <SFML/System/Time.hpp>
 
+#include "AudioClock.hpp"
+
 namespace Gameplay {
     // I'm rolling my own interface to allow for both Silence and
     // PreciseMusic to be used via an AbstractMusic pointer
@@ -13,5 +17,7 @@ namespace Gameplay {
         virtual void stop() = 0;
         virtual sf::SoundSource::Status getStatus() const = 0;
         virtual sf::Time getPlayingOffset() const = 0;
+        // Only for music that follows the audio device through an AudioClock
+        virtual std::optional<AudioClock::Stats> get_clock_stats() const {return {};};
     };
 }
\ No newline at end of file
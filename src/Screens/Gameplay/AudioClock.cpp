@@ -0,0 +1,154 @@
+#include "AudioClock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Gameplay {
+    namespace {
+        std::int64_t now_us() {
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+        }
+    }
+
+    void AudioClock::add_sample(std::int64_t system_us, std::int64_t audio_us) {
+        std::lock_guard lock{m_mutex};
+        if (m_sample_count > 0) {
+            m_stats.last_correction_ms = (predict(system_us) - static_cast<double>(audio_us)) / 1000.0;
+        }
+        m_samples[m_next_sample] = {system_us, audio_us};
+        m_next_sample = (m_next_sample + 1) % max_samples;
+        m_sample_count = std::min(m_sample_count + 1, max_samples);
+        refit();
+    }
+
+    void AudioClock::reset() {
+        std::lock_guard lock{m_mutex};
+        m_next_sample = 0;
+        m_sample_count = 0;
+        m_fit = {};
+        m_stats = {};
+        m_last_estimate = std::numeric_limits<std::int64_t>::min();
+    }
+
+    bool AudioClock::has_samples() const {
+        std::lock_guard lock{m_mutex};
+        return m_sample_count > 0;
+    }
+
+    std::int64_t AudioClock::estimate(std::int64_t system_us) const {
+        std::int64_t estimate;
+        {
+            std::lock_guard lock{m_mutex};
+            estimate = std::llround(predict(system_us));
+        }
+        auto last = m_last_estimate.load(std::memory_order_relaxed);
+        while (estimate > last) {
+            if (m_last_estimate.compare_exchange_weak(last, estimate, std::memory_order_relaxed)) {
+                return estimate;
+            }
+        }
+        return last;
+    }
+
+    AudioClock::Stats AudioClock::get_stats() const {
+        std::lock_guard lock{m_mutex};
+        return m_stats;
+    }
+
+    double AudioClock::predict(std::int64_t system_us) const {
+        return m_fit.origin_audio_us + m_fit.slope * static_cast<double>(system_us - m_fit.origin_system_us);
+    }
+
+    void AudioClock::refit() {
+        // Work relative to the newest sample to keep the doubles precise
+        const auto& newest = m_samples[(m_next_sample + max_samples - 1) % max_samples];
+        double mean_x = 0;
+        double mean_y = 0;
+        for (std::size_t i = 0; i < m_sample_count; i++) {
+            mean_x += static_cast<double>(m_samples[i].system_us - newest.system_us);
+            mean_y += static_cast<double>(m_samples[i].audio_us - newest.audio_us);
+        }
+        const auto count = static_cast<double>(m_sample_count);
+        mean_x /= count;
+        mean_y /= count;
+        double slope = 1;
+        if (m_sample_count >= min_samples_for_slope) {
+            double covariance = 0;
+            double variance = 0;
+            for (std::size_t i = 0; i < m_sample_count; i++) {
+                auto dx = static_cast<double>(m_samples[i].system_us - newest.system_us) - mean_x;
+                auto dy = static_cast<double>(m_samples[i].audio_us - newest.audio_us) - mean_y;
+                covariance += dx * dy;
+                variance += dx * dx;
+            }
+            if (variance > 0) {
+                // A real sound card is never off by more than a few hundred ppm,
+                // anything past this is the fit being thrown off by a hiccup
+                slope = std::clamp(covariance / variance, 0.99, 1.01);
+            }
+        }
+        m_fit.origin_system_us = newest.system_us;
+        m_fit.origin_audio_us = static_cast<double>(newest.audio_us) + mean_y - slope * mean_x;
+        m_fit.slope = slope;
+
+        double squared_residuals = 0;
+        for (std::size_t i = 0; i < m_sample_count; i++) {
+            auto residual = predict(m_samples[i].system_us) - static_cast<double>(m_samples[i].audio_us);
+            squared_residuals += residual * residual;
+        }
+        m_stats.sample_count = m_sample_count;
+        m_stats.jitter_ms = std::sqrt(squared_residuals / count) / 1000.0;
+        m_stats.drift_ppm = (slope - 1) * 1e6;
+    }
+
+    SoundStreamClock::SoundStreamClock(const sf::SoundStream& stream) :
+        m_stream(stream)
+    {
+    }
+
+    SoundStreamClock::~SoundStreamClock() {
+        m_should_stop = true;
+        if (m_sampler.joinable()) {
+            m_sampler.join();
+        }
+    }
+
+    void SoundStreamClock::start() {
+        if (not m_sampler.joinable()) {
+            m_sampler = std::thread{&SoundStreamClock::sampler_main, this};
+        }
+    }
+
+    sf::Time SoundStreamClock::get_playing_offset() const {
+        if (m_stream.getStatus() == sf::SoundSource::Playing and m_clock.has_samples()) {
+            return sf::microseconds(m_clock.estimate(now_us()));
+        } else {
+            return m_stream.getPlayingOffset();
+        }
+    }
+
+    void SoundStreamClock::sampler_main() {
+        bool was_playing = false;
+        sf::Time last_position = sf::Time::Zero;
+        while (not m_should_stop) {
+            if (m_stream.getStatus() == sf::SoundSource::Playing) {
+                auto position = m_stream.getPlayingOffset();
+                auto sampled_at = now_us();
+                if (not was_playing or position < last_position or position - last_position > sf::seconds(1)) {
+                    // resumed or seeked, the previous samples describe another stretch of audio
+                    m_clock.reset();
+                    m_clock.add_sample(sampled_at, position.asMicroseconds());
+                } else if (position != last_position) {
+                    m_clock.add_sample(sampled_at, position.asMicroseconds());
+                }
+                last_position = position;
+                was_playing = true;
+            } else {
+                was_playing = false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include <SFML/Audio/SoundStream.hpp>
+#include <SFML/System/Time.hpp>
+
+namespace Gameplay {
+    // Turns the coarse, stepping position reported by the audio device into a smooth one :
+    // readings are fitted against the system clock with a linear regression over the last
+    // few samples, the fit is then extrapolated to the current time.
+    // The slope of the fit follows any drift between the audio clock and the system clock.
+    // Times are in microseconds, samples come from one thread, estimates can be asked from any
+    class AudioClock {
+    public:
+        struct Stats {
+            std::size_t sample_count = 0;
+            // RMS distance between the readings and the fitted line
+            double jitter_ms = 0;
+            // how much faster the audio clock runs compared to the system clock
+            double drift_ppm = 0;
+            // estimate minus the last reading, at the time of that reading
+            double last_correction_ms = 0;
+        };
+
+        // To be called when the reading changes
+        void add_sample(std::int64_t system_us, std::int64_t audio_us);
+        // Forget every sample, for when playback was paused or the position jumped
+        void reset();
+        bool has_samples() const;
+        // Estimated audio position at system_us, never smaller than a previous estimate
+        // unless reset() was called in between
+        std::int64_t estimate(std::int64_t system_us) const;
+        Stats get_stats() const;
+    private:
+        struct Sample {
+            std::int64_t system_us;
+            std::int64_t audio_us;
+        };
+        // audio = origin_audio + slope * (system - origin_system)
+        struct Fit {
+            std::int64_t origin_system_us = 0;
+            double origin_audio_us = 0;
+            double slope = 1;
+        };
+        void refit();
+        double predict(std::int64_t system_us) const;
+
+        static constexpr std::size_t max_samples = 128;
+        // Below this many samples the slope is not trusted and assumed to be 1
+        static constexpr std::size_t min_samples_for_slope = 16;
+        std::array<Sample, max_samples> m_samples;
+        std::size_t m_next_sample = 0;
+        std::size_t m_sample_count = 0;
+
+        mutable std::mutex m_mutex;
+        Fit m_fit;
+        Stats m_stats;
+        mutable std::atomic<std::int64_t> m_last_estimate = std::numeric_limits<std::int64_t>::min();
+    };
+
+    // Polls the position OpenAL reports for a stream (buffers played + offset in the current one)
+    // on a thread of its own and feeds every change to an AudioClock.
+    // Has to be destroyed before the stream
+    class SoundStreamClock {
+    public:
+        explicit SoundStreamClock(const sf::SoundStream& stream);
+        ~SoundStreamClock();
+        SoundStreamClock(const SoundStreamClock&) = delete;
+        SoundStreamClock& operator=(const SoundStreamClock&) = delete;
+
+        // Starts polling, only call this once the stream is fully initialized.
+        // Until then get_playing_offset() is what the stream itself reports
+        void start();
+
+        sf::Time get_playing_offset() const;
+        AudioClock::Stats get_stats() const {return m_clock.get_stats();};
+    private:
+        void sampler_main();
+
+        const sf::SoundStream& m_stream;
+        AudioClock m_clock;
+        std::atomic<bool> m_should_stop = false;
+        std::thread m_sampler;
+    };
+}
@@ -0,0 +1,154 @@
+#include "ChartPreparation.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include <SFML/System/Clock.hpp>
+
+#include "DecodedMusic.hpp"
+#include "Silence.hpp"
+
+namespace Gameplay {
+    namespace {
+        template<class Selection>
+        bool same_chart(const std::optional<Selection>& a, const Data::SongDifficulty& b) {
+            return a.has_value() and a->matches(b);
+        }
+    }
+
+    Data::SongDifficulty ChartPreparation::Selection::view() const {
+        auto level = song->chart_levels.find(difficulty);
+        if (level != song->chart_levels.end()) {
+            return {*song, level->first};
+        }
+        return {*song, difficulty};
+    }
+
+    bool ChartPreparation::Selection::matches(const Data::SongDifficulty& song_selection) const {
+        return song->folder == song_selection.song.folder and difficulty == song_selection.difficulty;
+    }
+
+    ChartPreparation::ChartPreparation(Data::Preferences& t_preferences, Drawables::DensityGraphCache& t_density_graphs) :
+        preferences(t_preferences),
+        density_graphs(t_density_graphs),
+        m_worker(&ChartPreparation::worker_main, this)
+    {
+    }
+
+    ChartPreparation::~ChartPreparation() {
+        {
+            std::lock_guard lock{m_mutex};
+            m_should_stop = true;
+        }
+        m_condition.notify_all();
+        m_worker.join();
+    }
+
+    void ChartPreparation::prepare(const Data::SongDifficulty& song_selection) {
+        {
+            std::lock_guard lock{m_mutex};
+            if (is_known(song_selection)) {
+                return;
+            }
+            m_requested.emplace(Selection{song_selection});
+        }
+        m_condition.notify_all();
+    }
+
+    PreparedChart ChartPreparation::take(const Data::SongDifficulty& song_selection) {
+        {
+            std::unique_lock lock{m_mutex};
+            m_condition.wait(lock, [&](){
+                return not (same_chart(m_requested, song_selection) or same_chart(m_in_progress, song_selection));
+            });
+            if (same_chart(m_ready_for, song_selection) and m_ready) {
+                auto prepared = std::move(*m_ready);
+                m_ready.reset();
+                m_ready_for.reset();
+                return prepared;
+            }
+        }
+        return prepare_now(Selection{song_selection}.view());
+    }
+
+    void ChartPreparation::forget(const Data::Song& song) {
+        std::optional<PreparedChart> dropped;
+        {
+            std::lock_guard lock{m_mutex};
+            if (m_requested and m_requested->song == &song) {
+                m_requested.reset();
+            }
+            if (m_ready_for and m_ready_for->song == &song) {
+                m_ready_for.reset();
+                dropped = std::move(m_ready);
+                m_ready.reset();
+            }
+        }
+        m_condition.notify_all();
+    }
+
+    bool ChartPreparation::is_known(const Data::SongDifficulty& song_selection) const {
+        return (
+            same_chart(m_requested, song_selection)
+            or same_chart(m_in_progress, song_selection)
+            or same_chart(m_ready_for, song_selection)
+        );
+    }
+
+    void ChartPreparation::worker_main() {
+        while (true) {
+            std::optional<PreparedChart> previous;
+            std::optional<Selection> song_selection;
+            {
+                std::unique_lock lock{m_mutex};
+                m_condition.wait(lock, [&](){return m_should_stop or m_requested.has_value();});
+                if (m_should_stop) {
+                    return;
+                }
+                song_selection.emplace(*m_requested);
+                m_in_progress.emplace(*m_requested);
+                m_requested.reset();
+                // the previous chart is only dropped outside the lock, stopping its music can take a while
+                previous = std::move(m_ready);
+                m_ready.reset();
+                m_ready_for.reset();
+            }
+            previous.reset();
+            std::optional<PreparedChart> prepared;
+            try {
+                prepared.emplace(prepare_now(song_selection->view()));
+            } catch (const std::exception& e) {
+                // take() will try again and let the error through
+                std::cerr << "Could not prepare " << song_selection->song->title << " [" << song_selection->difficulty << "] : " << e.what() << '\n';
+            }
+            {
+                std::lock_guard lock{m_mutex};
+                m_in_progress.reset();
+                if (prepared) {
+                    m_ready_for.emplace(*song_selection);
+                    m_ready = std::move(prepared);
+                }
+            }
+            m_condition.notify_all();
+        }
+    }
+
+    PreparedChart ChartPreparation::prepare_now(const Data::SongDifficulty& song_selection) {
+        sf::Clock clock;
+        auto chart = song_selection.get_chart();
+        if (not chart) {
+            throw std::invalid_argument("No "+song_selection.difficulty+" chart in "+song_selection.song.title);
+        }
+        auto density_graph = density_graphs.blocking_get(song_selection);
+        std::unique_ptr<AbstractMusic> music;
+        auto music_path = song_selection.song.full_audio_path();
+        if (music_path) {
+            music = open_music(music_path->string(), preferences.options.max_decoded_music_mb * 1024 * 1024);
+        } else {
+            music = std::make_unique<Silence>(chart->get_last_event_timing());
+        }
+        std::cout << "Prepared " << song_selection.song.title << " [" << song_selection.difficulty << "] in " << clock.getElapsedTime().asMilliseconds() << "ms" << '\n';
+        return {chart, density_graph, std::move(music)};
+    }
+}
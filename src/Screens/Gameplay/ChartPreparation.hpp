@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "../../Data/Chart.hpp"
+#include "../../Data/Preferences.hpp"
+#include "../../Data/Song.hpp"
+#include "../../Drawables/DensityGraph.hpp"
+#include "AbstractMusic.hpp"
+
+namespace Gameplay {
+    // Everything Gameplay::Screen needs that takes time to load
+    struct PreparedChart {
+        std::shared_ptr<const Data::Chart> chart;
+        Drawables::DensityGraph density_graph;
+        // already decoding in the background if it's a DecodedMusic
+        std::unique_ptr<AbstractMusic> music;
+    };
+
+    // Prepares the chart selected on the music select screen on a thread of its own
+    // so that gameplay can start right away once START is pressed.
+    // Only the latest selection is kept, selecting another chart drops the previous one
+    class ChartPreparation {
+    public:
+        ChartPreparation(Data::Preferences& t_preferences, Drawables::DensityGraphCache& t_density_graphs);
+        ~ChartPreparation();
+        ChartPreparation(const ChartPreparation&) = delete;
+        ChartPreparation& operator=(const ChartPreparation&) = delete;
+
+        // Starts preparing in the background, does nothing if this chart is already being prepared
+        void prepare(const Data::SongDifficulty& song_selection);
+        // Waits for the background preparation to finish if there's one for this chart,
+        // prepares it right now otherwise
+        PreparedChart take(const Data::SongDifficulty& song_selection);
+        // Drop anything that refers to this song, to be called before it's deleted
+        void forget(const Data::Song& song);
+    private:
+        // SongDifficulty::difficulty refers to a string the music select screen overwrites
+        // when cycling through difficulties, so requests keep their own copy
+        struct Selection {
+            explicit Selection(const Data::SongDifficulty& song_selection) :
+                song(&song_selection.song),
+                difficulty(song_selection.difficulty)
+            {};
+            const Data::Song* song;
+            std::string difficulty;
+            // The difficulty refers to the song's chart_levels key when there is one,
+            // so it lives as long as the song does (it ends up as a DensityGraphCache key)
+            Data::SongDifficulty view() const;
+            bool matches(const Data::SongDifficulty& song_selection) const;
+        };
+
+        void worker_main();
+        PreparedChart prepare_now(const Data::SongDifficulty& song_selection);
+        bool is_known(const Data::SongDifficulty& song_selection) const;
+
+        Data::Preferences& preferences;
+        Drawables::DensityGraphCache& density_graphs;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::optional<Selection> m_requested;
+        std::optional<Selection> m_in_progress;
+        std::optional<Selection> m_ready_for;
+        std::optional<PreparedChart> m_ready;
+        bool m_should_stop = false;
+        std::thread m_worker;
+    };
+}
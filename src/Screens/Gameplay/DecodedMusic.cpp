@@ -0,0 +1,86 @@
+#include "DecodedMusic.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include "PreciseMusic.hpp"
+
+namespace Gameplay {
+    _DecodedMusic::_DecodedMusic(std::unique_ptr<sf::InputSoundFile> file) :
+        m_file(std::move(file)),
+        m_samples(m_file->getSampleCount()),
+        // one second per chunk like sf::Music, SoundStream keeps 3 of them queued.
+        // A whole number of frames so left and right samples never end up split across chunks
+        m_chunk_size(m_file->getSampleRate() * m_file->getChannelCount())
+    {
+        initialize(m_file->getChannelCount(), m_file->getSampleRate());
+        m_decoder = std::thread{&_DecodedMusic::decode, this};
+        // the sampler reads the stream, it can only start once initialize() is done
+        clock.start();
+    }
+
+    _DecodedMusic::~_DecodedMusic() {
+        // stop the streaming thread before the buffer goes away
+        stop();
+        m_should_stop_decoding = true;
+        m_decoder.join();
+    }
+
+    void _DecodedMusic::decode() {
+        std::size_t decoded = 0;
+        while (decoded < m_samples.size() and not m_should_stop_decoding) {
+            auto count = std::min(m_chunk_size, m_samples.size() - decoded);
+            auto read = static_cast<std::size_t>(m_file->read(m_samples.data() + decoded, count));
+            decoded += read;
+            m_decoded_samples.store(decoded, std::memory_order_release);
+            if (read < count) {
+                // the header announced more samples than the file actually has
+                break;
+            }
+        }
+        m_decoding_done.store(true, std::memory_order_release);
+    }
+
+    bool _DecodedMusic::onGetData(sf::SoundStream::Chunk& data) {
+        const std::size_t channels = getChannelCount();
+        // whole frames only
+        auto available_frames = [&](){
+            auto decoded = m_decoded_samples.load(std::memory_order_acquire);
+            auto available = decoded > m_position ? decoded - m_position : 0;
+            return available - available % channels;
+        };
+        auto available = available_frames();
+        while (available == 0 and not m_decoding_done.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            available = available_frames();
+        }
+        if (available == 0) {
+            return false;
+        }
+        auto count = std::min(m_chunk_size, available);
+        data.samples = m_samples.data() + m_position;
+        data.sampleCount = count;
+        m_position += count;
+        return true;
+    }
+
+    void _DecodedMusic::onSeek(sf::Time timeOffset) {
+        auto frame = static_cast<std::size_t>(std::max(0.0, timeOffset.asSeconds() * static_cast<double>(getSampleRate())));
+        m_position = std::min(frame * getChannelCount(), m_samples.size());
+    }
+
+    std::unique_ptr<AbstractMusic> open_music(const std::string& path, std::size_t max_decoded_bytes) {
+        auto file = std::make_unique<sf::InputSoundFile>();
+        if (not file->openFromFile(path)) {
+            throw std::invalid_argument("Could not open "+path);
+        }
+        auto decoded_bytes = file->getSampleCount() * sizeof(sf::Int16);
+        if (decoded_bytes > max_decoded_bytes) {
+            std::cout << "Decoded audio would take " << decoded_bytes / (1024 * 1024) << " MiB, streaming it from disk instead" << '\n';
+            return std::make_unique<PreciseMusic>(path);
+        }
+        return std::make_unique<DecodedMusic>(std::move(file));
+    }
+}
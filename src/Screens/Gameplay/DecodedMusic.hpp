@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Audio/SoundStream.hpp>
+#include <SFML/Config.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "AbstractMusic.hpp"
+#include "AudioClock.hpp"
+
+namespace Gameplay {
+    // Plays from a PCM buffer holding the whole track, decoded on a thread of its own
+    // as soon as this is created. Playback can start before decoding is done,
+    // the stream only waits if it catches up with the decoder
+    struct _DecodedMusic : sf::SoundStream {
+        // Takes over an already opened file
+        explicit _DecodedMusic(std::unique_ptr<sf::InputSoundFile> file);
+        ~_DecodedMusic();
+
+        sf::Time getPrecisePlayingOffset() const {return clock.get_playing_offset();};
+
+        SoundStreamClock clock{*this};
+    protected:
+        bool onGetData(sf::SoundStream::Chunk& data) override;
+        void onSeek(sf::Time timeOffset) override;
+    private:
+        void decode();
+
+        std::unique_ptr<sf::InputSoundFile> m_file;
+        std::vector<sf::Int16> m_samples;
+        // m_samples[0, m_decoded_samples) is ready to be played
+        std::atomic<std::size_t> m_decoded_samples = 0;
+        std::atomic<bool> m_decoding_done = false;
+        std::atomic<bool> m_should_stop_decoding = false;
+        std::thread m_decoder;
+        std::size_t m_position = 0;
+        std::size_t m_chunk_size;
+    };
+
+    struct DecodedMusic : AbstractMusic {
+        explicit DecodedMusic(std::unique_ptr<sf::InputSoundFile> file) : m_decoded_music(std::move(file)) {};
+        void play() override {m_decoded_music.play();};
+        void pause() override {m_decoded_music.pause();};
+        void stop() override {m_decoded_music.stop();};
+        sf::SoundSource::Status getStatus() const override {return m_decoded_music.getStatus();};
+        sf::Time getPlayingOffset() const override {return m_decoded_music.getPrecisePlayingOffset();};
+        std::optional<AudioClock::Stats> get_clock_stats() const override {return m_decoded_music.clock.get_stats();};
+    private:
+        _DecodedMusic m_decoded_music;
+    };
+
+    // Decodes the track in memory if its PCM data fits in max_decoded_bytes,
+    // streams it from disk otherwise
+    std::unique_ptr<AbstractMusic> open_music(const std::string& path, std::size_t max_decoded_bytes);
+}
@@ -2,7 +2,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <ctime>
+#include <iostream>
 #include <optional>
+#include <sstream>
 #include <thread>
 #include <utility>
 
@@ -13,8 +16,6 @@
 #include "../../Input/Buttons.hpp"
 #include "../../Toolkit/AffineTransform.hpp"
 #include "../../Toolkit/SFMLHelpers.hpp"
-#include "PreciseMusic.hpp"
-#include "Silence.hpp"
 
 namespace Gameplay {
 
@@ -28,128 +29,134 @@ namespace Gameplay {
         };
     }
 
-    Screen::Screen(const Data::SongDifficulty& t_song_selection, ScreenResources& t_resources) :
+    Screen::Screen(
+        const Data::SongDifficulty& t_song_selection,
+        PreparedChart t_prepared_chart,
+        ScreenResources& t_resources,
+        std::optional<Data::Replay> t_replay
+    ) :
         HoldsResources(t_resources),
         song_selection(t_song_selection),
-        chart(*t_song_selection.song.get_chart(t_song_selection.difficulty)),
+        chart(std::move(t_prepared_chart.chart)),
         marker(t_resources.shared.get_selected_marker()),
         ln_marker(t_resources.shared.get_selected_ln_marker()),
-        graded_density_graph(t_resources.shared.density_graphs.blocking_get(t_song_selection), t_song_selection),
+        marker_atlas(t_resources.shared.get_selected_marker_atlas()),
+        music(std::move(t_prepared_chart.music)),
+        graded_density_graph(t_prepared_chart.density_graph, t_song_selection),
         music_time_to_progression(get_music_time_to_progression_transform(t_song_selection)),
-        score(t_song_selection.song.get_chart(t_song_selection.difficulty)->notes)
+        simulation(*chart),
+        replay(std::move(t_replay)),
+        audio_offset(replay ? replay->audio_offset : preferences.options.audio_offset),
+        combo_text(t_resources.shared.fallback_font.black),
+        score_text(t_resources.shared.fallback_font.black),
+        song_title_label(t_resources.shared.fallback_font.medium),
+        song_artist_label(t_resources.shared.fallback_font.medium),
+        level_label(t_resources.shared.fallback_font.medium),
+        level_number_label(t_resources.shared.fallback_font.black),
+        chart_label(t_resources.shared.fallback_font.medium)
     {
-        for (auto&& note : chart.notes) {
-            notes.emplace_back(Data::GradedNote{note});
+        // Labels that stay the same for the whole chart, only their size follows the window
+        combo_text.set_fill_color(sf::Color(18, 59, 135));
+        combo_text.set_origin_normalized(0.5f, 0.5f);
+        score_text.set_fill_color(sf::Color(29, 98, 226));
+        score_text.set_origin_normalized(1.f, 1.f);
+        song_title_label.set_string(song_selection.song.title);
+        song_title_label.set_fill_color(sf::Color::White);
+        song_title_label.set_origin_normalized(0.f, 1.f);
+        song_artist_label.set_string(song_selection.song.artist);
+        song_artist_label.set_style(sf::Text::Italic);
+        song_artist_label.set_fill_color(sf::Color::White);
+        level_label.set_string("LEVEL:");
+        level_label.set_fill_color(sf::Color::White);
+        level_label.set_origin_normalized(1.f, 1.f);
+        level_number_label.set_number(chart->level);
+        level_number_label.set_fill_color(sf::Color::White);
+        level_number_label.set_origin_normalized(0.5f, 0.f);
+        std::string full_difficulty = song_selection.difficulty;
+        if (full_difficulty == "BSC") {
+            full_difficulty = "BASIC";
+        } else if (full_difficulty == "ADV") {
+            full_difficulty = "ADVANCED";
+        } else if (full_difficulty == "EXT") {
+            full_difficulty = "EXTREME";
         }
-        auto music_path = song_selection.song.full_audio_path();
-        if (music_path) {
-            music = std::make_unique<PreciseMusic>(music_path->string());
+        chart_label.set_string(full_difficulty);
+        chart_label.set_fill_color(shared.get_chart_color(song_selection.difficulty));
+        chart_label.set_origin_normalized(1.f, 1.f);
+        if (replay) {
+            if (replay->chart_hash != Data::chart_hash(*chart)) {
+                std::cerr << "The chart changed since this replay was recorded, it will not play back the same" << '\n';
+            }
         } else {
-            music = std::make_unique<Silence>(chart.get_last_event_timing());
+            recorded_events.reserve(2 * chart->notes.size());
+        }
+        if (preferences.options.evdev_input and not replay) {
+            evdev_input = std::make_unique<Input::EvdevInput>();
         }
-        ln_tail_layer.setSmooth(true);
-        marker_layer.setSmooth(true);
     }
 
     DetailedScore Screen::play_chart(sf::RenderWindow& window) {
         window.setKeyRepeatEnabled(false);
         window.setActive(false);
+        publish_grading_snapshot();
         std::thread render_thread(&Screen::render, this, std::ref(window));
         while ((not song_finished) and window.isOpen()) {
-            auto music_time = music->getPlayingOffset() - preferences.options.audio_offset;
+            auto music_time = music->getPlayingOffset() - audio_offset;
+            // sampled together so evdev timestamps can be converted to music time
+            const auto now_us = Input::monotonic_now_us();
             sf::Event event;
             while (window.pollEvent(event)) {
                 ImGui::SFML::ProcessEvent(event);
-                events_queue.push({music_time, event});
+                handle_input_event(event, music_time);
             }
+            handle_evdev_events(music_time, now_us);
+            play_replay_events(music_time);
+            simulation.update(music_time);
+            publish_grading_snapshot();
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
         if (render_thread.joinable()) {
             render_thread.join();
         }
-        return {graded_density_graph, score};
+        // The render thread may have stopped before seeing the last grades
+        apply_density_graph_grades(simulation.get_density_graph_grade_count());
+        if (not replay) {
+            save_replay();
+        }
+        return {graded_density_graph, simulation.get_score()};
     }
     
     void Screen::render(sf::RenderWindow& window) {
         window.setActive(true);
-        auto window_size = window.getSize();
-        ln_tail_layer.create(window_size.x, window_size.y);
-        marker_layer.create(window_size.x, window_size.y);
         sf::Clock imguiClock;
+        sf::Clock frame_clock;
         music->play();
         while ((not song_finished) and window.isOpen()) {
             song_finished = music->getStatus() == sf::Music::Stopped;
             ImGui::SFML::Update(window, imguiClock.restart());
-            auto music_time = music->getPlayingOffset() - preferences.options.audio_offset;
-            update_visible_notes(music_time);
+            // exponential moving average over roughly the last 64 frames
+            average_frame_time_ms += (frame_clock.restart().asSeconds()*1000.f - average_frame_time_ms) / 64.f;
+            auto music_time = music->getPlayingOffset() - audio_offset;
+            grading_snapshots.update();
+            const auto& snapshot = grading_snapshots.read_buffer();
+            apply_density_graph_grades(snapshot.density_graph_grade_count);
             graded_density_graph.update(music_time);
 
-            // Event Handling
             while (auto timed_event = events_queue.pop()) {
-                switch (timed_event->event.type) {
-                case sf::Event::KeyPressed:
-                    handle_raw_input_event({timed_event->event.key.code, Input::EventType::Pressed}, timed_event->time);
-                    break;
-                case sf::Event::KeyReleased:
-                    handle_raw_input_event({timed_event->event.key.code, Input::EventType::Released}, timed_event->time);
-                    break;
-                case sf::Event::JoystickButtonPressed:
-                    handle_raw_input_event({timed_event->event.joystickButton, Input::EventType::Pressed}, timed_event->time);
-                    break;
-                case sf::Event::JoystickButtonReleased:
-                    handle_raw_input_event({timed_event->event.joystickButton, Input::EventType::Released}, timed_event->time);
-                    break;
-                case sf::Event::MouseButtonPressed:
-                    handle_mouse_click(timed_event->event.mouseButton, timed_event->time);
-                    break;
-                case sf::Event::MouseButtonReleased:
-                    handle_mouse_release(timed_event->event.mouseButton, timed_event->time);
-                    break;
-                case sf::Event::MouseMoved:
-                    handle_mouse_move(timed_event->event.mouseMove, timed_event->time);
-                    break;
-                case sf::Event::TouchBegan:
-                    handle_touch_began(timed_event->event.touch, timed_event->time);
-                    break;
-                case sf::Event::TouchMoved:
-                    handle_touch_moved(timed_event->event.touch, timed_event->time);
-                    break;
-                case sf::Event::TouchEnded:
-                    handle_touch_ended(timed_event->event.touch, timed_event->time);
-                    break;
-                case sf::Event::Closed:
-                    window.close();
-                    break;
-                case sf::Event::Resized:
-                    // update the view to the new size of the window
-                    window.setView(
-                        sf::View(
-                            {
-                                0,
-                                0,
-                                static_cast<float>(timed_event->event.size.width),
-                                static_cast<float>(timed_event->event.size.height)
-                            }
-                        )
-                    );
-                    ln_tail_layer.create(timed_event->event.size.width, timed_event->event.size.height);
-                    marker_layer.create(timed_event->event.size.width, timed_event->event.size.height);
-                    preferences.screen.video_mode.height = timed_event->event.size.height;
-                    preferences.screen.video_mode.width = timed_event->event.size.width;
-                    shared.button_highlight.setPosition(get_ribbon_x(), get_ribbon_y());
-                    break;
-                default:
-                    break;
-                }
+                handle_window_event(window, timed_event->event);
+            }
+            while (auto button_event = button_highlight_events.pop()) {
+                shared.button_highlight.handle_button_event(*button_event);
             }
             window.clear(sf::Color(7, 23, 53));
-            ln_tail_layer.clear(sf::Color::Transparent);
-            marker_layer.clear(sf::Color::Transparent);
+            ln_tail_batch.clear();
+            ln_note_batch.clear();
+            marker_batch.clear();
 
             // Don't display shutter for now : it's fucking ugly
             // TODO: make fallback shutter not sinfully ugly
             /*
-            shutter.update(score.get_shutter());
+            shutter.update(snapshot.shutter);
             shutter.setScale(get_ribbon_size()/1080.f, get_ribbon_size()/1080.f);
             shutter.setPosition(get_ribbon_x(), get_ribbon_y());
             window.draw(shutter);
@@ -196,13 +203,9 @@ namespace Gameplay {
 
 
             // Draw Combo
-            if (combo >= 4) {
-                sf::Text combo_text;
-                combo_text.setFont(shared.fallback_font.black);
-                combo_text.setFillColor(sf::Color(18, 59, 135));
-                combo_text.setString(std::to_string(combo));
-                combo_text.setCharacterSize(static_cast<unsigned int>(1.5*get_panel_step()));
-                Toolkit::set_local_origin_normalized(combo_text, 0.5f, 0.5f);
+            if (snapshot.combo >= 4) {
+                combo_text.set_number(static_cast<long long>(snapshot.combo));
+                combo_text.set_character_size(static_cast<unsigned int>(1.5*get_panel_step()));
                 combo_text.setPosition(
                     get_ribbon_x()+get_ribbon_size()*0.5f,
                     get_ribbon_y()+get_ribbon_size()*0.5f
@@ -211,13 +214,8 @@ namespace Gameplay {
             }
 
             // Draw score
-            auto current_score = score.get_score();
-            sf::Text score_text;
-            score_text.setFont(shared.fallback_font.black);
-            score_text.setFillColor(sf::Color(29, 98, 226));
-            score_text.setString(std::to_string(current_score));
-            score_text.setCharacterSize(static_cast<unsigned int>(45.f/768.f*get_screen_width()));
-            Toolkit::set_local_origin_normalized(score_text, 1.f, 1.f);
+            score_text.set_number(snapshot.score);
+            score_text.set_character_size(static_cast<unsigned int>(45.f/768.f*get_screen_width()));
             score_text.setPosition(
                 500.f/768.f*get_screen_width(),
                 370.f/768.f*get_screen_width()
@@ -225,82 +223,58 @@ namespace Gameplay {
             window.draw(score_text);
 
             // Draw song info
-            auto song_title = song_selection.song.title;
-            if (not song_title.empty()) {
-                sf::Text song_title_label{
-                    sf::String::fromUtf8(song_title.begin(), song_title.end()),
-                    shared.fallback_font.medium,
-                    static_cast<unsigned int>(scale(20.f))
-                };
-                Toolkit::set_local_origin_normalized(song_title_label, 0.f, 1.f);
-                song_title_label.setFillColor(sf::Color::White);
+            if (not song_title_label.empty()) {
+                song_title_label.set_character_size(static_cast<unsigned int>(scale(20.f)));
                 song_title_label.setPosition(scale(440.f), scale(40.f));
                 window.draw(song_title_label);
             }
-            auto song_artist = song_selection.song.artist;
-            if (not song_artist.empty()) {
-                sf::Text song_artist_label{
-                    sf::String::fromUtf8(song_artist.begin(), song_artist.end()),
-                    shared.fallback_font.medium,
-                    static_cast<unsigned int>(scale(12.f))
-                };
-                song_artist_label.setStyle(sf::Text::Italic);
-                song_artist_label.setFillColor(sf::Color::White);
+            if (not song_artist_label.empty()) {
+                song_artist_label.set_character_size(static_cast<unsigned int>(scale(12.f)));
                 song_artist_label.setPosition(scale(440.f), scale(45.f));
                 window.draw(song_artist_label);
             }
-            sf::Text level_label{
-                "LEVEL:",
-                shared.fallback_font.medium,
-                static_cast<unsigned int>(scale(10.f))
-            };
-            Toolkit::set_origin_normalized(level_label, 1.f, 1.f);
+            level_label.set_character_size(static_cast<unsigned int>(scale(10.f)));
             level_label.setPosition(scale(322.f), scale(35.f));
-            level_label.setFillColor(sf::Color::White);
             window.draw(level_label);
-            
-            sf::Text level_number_label{
-                std::to_string(chart.level),
-                shared.fallback_font.black,
-                static_cast<unsigned int>(scale(35.f))
-            };
-            Toolkit::set_origin_normalized(level_number_label, 0.5f, 0.f);
+
+            level_number_label.set_character_size(static_cast<unsigned int>(scale(35.f)));
             level_number_label.setPosition(scale(351.f), scale(24.f));
-            level_number_label.setFillColor(sf::Color::White);
             window.draw(level_number_label);
 
-            std::string full_difficulty = song_selection.difficulty;
-            if (full_difficulty == "BSC") {
-                full_difficulty = "BASIC";
-            } else if (full_difficulty == "ADV") {
-                full_difficulty = "ADVANCED";
-            } else if (full_difficulty == "EXT") {
-                full_difficulty = "EXTREME";
-            }
-
-            sf::Text chart_label{
-                sf::String::fromUtf8(full_difficulty.begin(), full_difficulty.end()),
-                shared.fallback_font.medium,
-                static_cast<unsigned int>(scale(16.f))
-            };
-            Toolkit::set_local_origin_normalized(chart_label, 1.f, 1.f);
+            chart_label.set_character_size(static_cast<unsigned int>(scale(16.f)));
             chart_label.setPosition(scale(322.f), scale(55.f));
-            chart_label.setFillColor(shared.get_chart_color(song_selection.difficulty));
             window.draw(chart_label);
 
-            // Draw Notes, longs first then normal ones
-            for (auto &&note_ref : visible_notes) {
-                const auto& note = note_ref.get();
+            // Draw Notes, oldest first
+            for (const auto& note : snapshot.notes) {
                 if (note.duration == sf::Time::Zero) {
                     draw_tap_note(note, music_time);
                 } else {
                     draw_long_note(note, music_time);
                 }
             }
-            ln_tail_layer.display();
-            marker_layer.display();
-            window.draw(sf::Sprite{ln_tail_layer.getTexture()});
-            window.draw(sf::Sprite{marker_layer.getTexture()});
+            // Straight to the window, every long note tail under every long note tip and background,
+            // themselves under every marker
+            marker_sprite_count = (
+                ln_tail_batch.get_sprite_count()
+                + ln_note_batch.get_sprite_count()
+                + marker_batch.get_sprite_count()
+            );
+            if (batch_markers) {
+                window.draw(ln_tail_batch);
+                window.draw(ln_note_batch);
+                window.draw(marker_batch);
+                marker_draw_calls = (
+                    ln_tail_batch.get_draw_call_count()
+                    + ln_note_batch.get_draw_call_count()
+                    + marker_batch.get_draw_call_count()
+                );
+            } else {
+                ln_tail_batch.draw_one_by_one(window);
+                ln_note_batch.draw_one_by_one(window);
+                marker_batch.draw_one_by_one(window);
+                marker_draw_calls = marker_sprite_count;
+            }
 
             shared.button_highlight.update();
             window.draw(shared.button_highlight);
@@ -335,7 +309,7 @@ namespace Gameplay {
                 get_ribbon_x()+get_panel_step()*pos.x,
                 get_ribbon_y()+get_panel_step()*pos.y
             );
-            marker_layer.draw(*sprite);
+            draw_marker_sprite(marker_batch, *sprite);
         }
     }
 
@@ -386,7 +360,7 @@ namespace Gameplay {
                     tail_sprite->setPosition(note_position);
                     tail_sprite->rotate(tail_angle+180.f);
                     tail_sprite->setScale(scale, scale);
-                    ln_tail_layer.draw(*tail_sprite);
+                    draw_marker_sprite(ln_tail_batch, *tail_sprite);
                 }
                 if (auto tip_sprite = ln_marker.get_tip_sprite(note_offset)) {
                     Toolkit::set_origin_normalized(
@@ -397,28 +371,28 @@ namespace Gameplay {
                     tip_sprite->setPosition(note_position);
                     tip_sprite->setRotation(tail_angle);
                     tip_sprite->setScale(scale, scale);
-                    ln_tail_layer.draw(*tip_sprite);
+                    draw_marker_sprite(ln_note_batch, *tip_sprite);
                 }
                 if (auto background_sprite = ln_marker.get_background_sprite(note_offset)) {
                     Toolkit::set_origin_normalized(*background_sprite, 0.5f, 0.5f);
                     background_sprite->setPosition(note_position);
                     background_sprite->setRotation(tail_angle);
                     background_sprite->setScale(scale, scale);
-                    ln_tail_layer.draw(*background_sprite);
+                    draw_marker_sprite(ln_note_batch, *background_sprite);
                 }
                 if (auto outline_sprite = ln_marker.get_outline_sprite(note_offset)) {
                     Toolkit::set_origin_normalized(*outline_sprite, 0.5f, 0.5f);
                     outline_sprite->setPosition(note_position);
                     outline_sprite->setRotation(tail_angle);
                     outline_sprite->setScale(scale, scale);
-                    ln_tail_layer.draw(*outline_sprite);                  
+                    draw_marker_sprite(ln_note_batch, *outline_sprite);
                 }
                 if (auto highlight_sprite = ln_marker.get_highlight_sprite(note_offset)) {
                     Toolkit::set_origin_normalized(*highlight_sprite, 0.5f, 0.5f);
                     highlight_sprite->setPosition(note_position);
                     highlight_sprite->setRotation(tail_angle);
                     highlight_sprite->setScale(scale, scale);
-                    ln_tail_layer.draw(*highlight_sprite);
+                    draw_marker_sprite(ln_note_batch, *highlight_sprite);
                 }
             }
             draw_tap_note(note, music_time);
@@ -436,11 +410,15 @@ namespace Gameplay {
                     get_ribbon_x()+get_panel_step()*pos.x,
                     get_ribbon_y()+get_panel_step()*pos.y
                 );
-                marker_layer.draw(*sprite);
+                draw_marker_sprite(marker_batch, *sprite);
             }
         }
     }
 
+    void Screen::draw_marker_sprite(Toolkit::SpriteBatch& batch, const sf::Sprite& sprite) {
+        batch.add(marker_atlas.remap(sprite));
+    }
+
     std::optional<Input::Button> Screen::button_from_position(sf::Vector2i mouse_position) {
         sf::Vector2i ribbon_origin{
             static_cast<int>(get_ribbon_x()),
@@ -529,189 +507,254 @@ namespace Gameplay {
         }
     }
 
-    void Screen::handle_raw_input_event(const Input::RawEvent& raw_event, const sf::Time& music_time) {
-        auto button = preferences.key_mapping.key_to_button(raw_event.key);
-        if (button) {
-            handle_button_event({*button, raw_event.type}, music_time);
-        } else if (raw_event.type == Input::EventType::Pressed) {
-            if (auto key = std::get_if<sf::Keyboard::Key>(&raw_event.key)) {
-                switch (*key) {
-                case sf::Keyboard::F12:
-                    debug = not debug;
-                    graded_density_graph.debug = not graded_density_graph.debug;
-                    break;
-                default:
-                    break;
+    void Screen::handle_input_event(const sf::Event& event, const sf::Time& music_time) {
+        if (replay) {
+            // buttons only come from the replay, keys, mouse and touches that would press them are dropped
+            switch (event.type) {
+            case sf::Event::KeyPressed:
+                if (not preferences.key_mapping.key_to_button(event.key.code)) {
+                    events_queue.push({music_time, event});
                 }
+                break;
+            case sf::Event::Closed:
+            case sf::Event::Resized:
+                events_queue.push({music_time, event});
+                break;
+            default:
+                break;
             }
+            return;
+        }
+        switch (event.type) {
+        case sf::Event::KeyPressed:
+            if (read_by_evdev(event.key.code)) {
+                break;
+            }
+            if (not handle_raw_input_event({event.key.code, Input::EventType::Pressed}, music_time)) {
+                events_queue.push({music_time, event});
+            }
+            break;
+        case sf::Event::KeyReleased:
+            if (read_by_evdev(event.key.code)) {
+                break;
+            }
+            handle_raw_input_event({event.key.code, Input::EventType::Released}, music_time);
+            break;
+        case sf::Event::JoystickButtonPressed:
+            handle_raw_input_event({event.joystickButton, Input::EventType::Pressed}, music_time);
+            break;
+        case sf::Event::JoystickButtonReleased:
+            handle_raw_input_event({event.joystickButton, Input::EventType::Released}, music_time);
+            break;
+        case sf::Event::MouseButtonPressed:
+            handle_mouse_click(event.mouseButton, music_time);
+            break;
+        case sf::Event::MouseButtonReleased:
+            handle_mouse_release(event.mouseButton, music_time);
+            break;
+        case sf::Event::MouseMoved:
+            handle_mouse_move(event.mouseMove, music_time);
+            break;
+        case sf::Event::TouchBegan:
+            handle_touch_began(event.touch, music_time);
+            break;
+        case sf::Event::TouchMoved:
+            handle_touch_moved(event.touch, music_time);
+            break;
+        case sf::Event::TouchEnded:
+            handle_touch_ended(event.touch, music_time);
+            break;
+        case sf::Event::Closed:
+        case sf::Event::Resized:
+            events_queue.push({music_time, event});
+            break;
+        default:
+            break;
         }
     }
 
-    void Screen::handle_button_event(const Input::ButtonEvent& button_event, const sf::Time& music_time) {
-        shared.button_highlight.handle_button_event(button_event);
-        // Is the music even playing ?
-        if (music->getStatus() == sf::SoundSource::Playing) {
-            switch (button_event.type) {
-            case Input::EventType::Pressed:
-                handle_button_press(button_event.button, music_time);
+    void Screen::handle_window_event(sf::RenderWindow& window, const sf::Event& event) {
+        switch (event.type) {
+        case sf::Event::KeyPressed:
+            switch (event.key.code) {
+            case sf::Keyboard::F12:
+                debug = not debug;
+                graded_density_graph.debug = not graded_density_graph.debug;
                 break;
-            case Input::EventType::Released:
-                handle_button_release(button_event.button, music_time);
+            default:
                 break;
             }
+            break;
+        case sf::Event::Closed:
+            window.close();
+            break;
+        case sf::Event::Resized:
+            // update the view to the new size of the window
+            window.setView(
+                sf::View(
+                    {
+                        0,
+                        0,
+                        static_cast<float>(event.size.width),
+                        static_cast<float>(event.size.height)
+                    }
+                )
+            );
+            preferences.screen.video_mode.height = event.size.height;
+            preferences.screen.video_mode.width = event.size.width;
+            shared.button_highlight.setPosition(get_ribbon_x(), get_ribbon_y());
+            break;
+        default:
+            break;
         }
     }
 
-    void Screen::handle_button_press(const Input::Button& button, const sf::Time& music_time) {
-        for (auto&& note_ref : visible_notes) {
-            auto& note = note_ref.get();
-            // is it even the right button ?
-            if (note.position != button) {
-                continue;
-            }
-            // has it already been graded ?
-            if (note.tap_judgement) {
-                continue;
-            }
-            note = Data::GradedNote{note, music_time-note.timing};
-            auto& judgement = note.tap_judgement->judgement;
-            score.update(judgement);
-            graded_density_graph.update_grades(judgement, note.timing);
-            if (Data::judgement_breaks_combo(judgement)) {
-                // If we've broken combo at the begining of a long we also missed the end
-                if (note.duration > sf::Time::Zero) {
-                    note.long_release = Data::TimedJudgement{sf::Time::Zero, Data::Judgement::Miss};
-                    score.update(Data::Judgement::Miss);
-                    graded_density_graph.update_grades(Data::Judgement::Miss, note.timing+note.duration);
-                }
-                combo = 0;
-            } else {
-                combo++;
-            }
-            return;
+    bool Screen::handle_raw_input_event(const Input::RawEvent& raw_event, const sf::Time& music_time) {
+        auto button = preferences.key_mapping.key_to_button(raw_event.key);
+        if (not button) {
+            return false;
         }
+        handle_button_event({*button, raw_event.type}, music_time);
+        return true;
     }
 
-    void Screen::handle_button_release(const Input::Button& button, const sf::Time& music_time) {
-        for (auto&& note_ref : visible_notes) {
-            auto& note = note_ref.get();
-            // is it a long note ?
-            if (note.duration == sf::Time::Zero) {
-                continue;
-            }
-            // is it even the right button ?
-            if (note.position != button) {
-                continue;
-            }
-            // has it been correctly hit ?
-            if (not note.tap_judgement) {
-                continue;
-            }
-            // has it already been graded for release ?
-            if (note.long_release) {
-                continue;
-            }
-            auto timed_judgement = Data::TimedJudgement{music_time-note.timing-note.duration};
-            note.long_release = timed_judgement;
-            score.update(timed_judgement.judgement);
-            graded_density_graph.update_grades(timed_judgement.judgement, note.timing+note.duration);
-            if (Data::judgement_breaks_combo(timed_judgement.judgement)) {
-                combo = 0;
-            } else {
-                combo++;
-            }
+    void Screen::handle_evdev_events(const sf::Time& music_time, std::int64_t now_us) {
+        if (not evdev_input) {
             return;
         }
+        while (auto key_event = evdev_input->pop()) {
+            auto event_time = music_time - sf::microseconds(now_us - key_event->timestamp_us);
+            handle_raw_input_event({key_event->key, key_event->type}, event_time);
+        }
     }
 
-    void Screen::miss_old_notes(const sf::Time& music_time) {
-        for (auto &&note_ref : visible_notes) {
-            auto& note = note_ref.get();
-            if (
-                (not note.tap_judgement.has_value())
-                and (note.timing < music_time - sf::seconds(16.f/30.f))
-            ) {
-                auto timed_judgement = Data::TimedJudgement{sf::Time::Zero, Data::Judgement::Miss};
-                note.tap_judgement = timed_judgement;
-                score.update(Data::Judgement::Miss);
-                graded_density_graph.update_grades(Data::Judgement::Miss, note.timing);
-                if (note.duration > sf::Time::Zero) {
-                    note.long_release = timed_judgement;
-                    score.update(Data::Judgement::Miss);
-                    graded_density_graph.update_grades(Data::Judgement::Miss, note.timing+note.duration);
-                }
-                combo = 0;
-            }
+    bool Screen::read_by_evdev(const sf::Keyboard::Key& key) const {
+        if (not (evdev_input and evdev_input->is_running())) {
+            return false;
         }
+        return preferences.key_mapping.key_to_button(key).has_value();
     }
 
-    void Screen::release_finished_longs(const sf::Time& music_time) {
-        for (auto &&note_ref : visible_notes) {
-            auto& note = note_ref.get();
-            if (
-                (note.duration > sf::Time::Zero)
-                and (note.timing + note.duration < music_time)
-                and note.tap_judgement.has_value()
-                and not Data::judgement_breaks_combo(note.tap_judgement->judgement)
-                and (not note.long_release.has_value())
-            ) {
-                auto timed_judgement = Data::TimedJudgement{sf::Time::Zero, Data::Judgement::Perfect};
-                note.long_release = timed_judgement;
-                score.update(timed_judgement.judgement);
-                graded_density_graph.update_grades(timed_judgement.judgement, note.timing + note.duration);
-                combo++;
-            }
+    void Screen::publish_grading_snapshot() {
+        auto& snapshot = grading_snapshots.write_buffer();
+        const auto& notes = simulation.get_notes();
+        snapshot.notes.clear();
+        for (const auto& index : simulation.get_lingering_longs()) {
+            snapshot.notes.push_back(notes[index]);
         }
+        snapshot.notes.insert(
+            snapshot.notes.end(),
+            notes.begin() + static_cast<std::ptrdiff_t>(simulation.get_visible_begin()),
+            notes.begin() + static_cast<std::ptrdiff_t>(simulation.get_visible_end())
+        );
+        const auto& score = simulation.get_score();
+        snapshot.combo = simulation.get_combo();
+        snapshot.score = score.get_score();
+        snapshot.final_score = score.get_final_score();
+        snapshot.shutter = score.get_shutter();
+        snapshot.judgement_counts = {
+            score.get_judgement_count(Data::Judgement::Perfect),
+            score.get_judgement_count(Data::Judgement::Great),
+            score.get_judgement_count(Data::Judgement::Good),
+            score.get_judgement_count(Data::Judgement::Poor),
+            score.get_judgement_count(Data::Judgement::Miss),
+        };
+        snapshot.density_graph_grade_count = simulation.get_density_graph_grade_count();
+        grading_snapshots.publish();
     }
 
-    void Screen::update_visible_notes(const sf::Time& music_time) {
-        // Mark old notes as missed and finished longs as released
-        miss_old_notes(music_time);
-        release_finished_longs(music_time);
-        
-        // Remove old notes
-        visible_notes.erase(
-            std::remove_if(visible_notes.begin(), visible_notes.end(),
-                [music_time](Data::GradedNote& note) -> bool {
-                    return note.timing + note.duration < music_time - sf::seconds(16.f/30.f);
-                }
-            ),
-            visible_notes.end()
-        );
-        
-        // Add new notes
-        Data::GradedNote lower_note, upper_note;
-        if (visible_notes.empty()) {
-            lower_note.position = Input::Button::B16;
-            lower_note.timing = music_time - sf::seconds(16.f/30.f);
-        } else {
-            lower_note = *visible_notes.rbegin();
-        }
-        upper_note.position = Input::Button::B1;
-        upper_note.timing = music_time + sf::seconds(16.f/30.f);
-        auto new_notes_begin = std::upper_bound(notes.begin(), notes.end(), lower_note);
-        auto new_notes_end = std::upper_bound(new_notes_begin, notes.end(), upper_note);
-        std::for_each(new_notes_begin, new_notes_end,
-            [this](Data::GradedNote& note){
-                this->visible_notes.emplace_back(note);
+    void Screen::apply_density_graph_grades(std::size_t count) {
+        for (; applied_density_graph_grades < count; applied_density_graph_grades++) {
+            const auto& [judgement, timing] = simulation.get_density_graph_grades()[applied_density_graph_grades];
+            graded_density_graph.update_grades(judgement, timing);
+        }
+    }
+
+    void Screen::handle_button_event(const Input::ButtonEvent& button_event, const sf::Time& music_time) {
+        if (not button_highlight_events.push(button_event)) {
+            dropped_button_highlight_events++;
+        }
+        // Is the music even playing ?
+        if (music->getStatus() == sf::SoundSource::Playing) {
+            // Grading must only depend on event times for replays to grade the same way :
+            // update up to the event first, and never judge before a time update() already went past
+            // (evdev timestamps can be a bit older than the last music time)
+            auto time = music_time;
+            if (auto latest_update = simulation.get_latest_update(); latest_update and *latest_update > time) {
+                time = *latest_update;
             }
-        );
+            simulation.update(time);
+            simulation.handle_button_event(button_event, time);
+            if (not replay) {
+                recorded_events.push_back({time, button_event});
+            }
+        }
+    }
+
+    void Screen::play_replay_events(const sf::Time& music_time) {
+        if (not replay) {
+            return;
+        }
+        while (next_replay_event < replay->events.size() and replay->events[next_replay_event].time <= music_time) {
+            const auto& [time, event] = replay->events[next_replay_event];
+            handle_button_event(event, time);
+            next_replay_event++;
+        }
+    }
+
+    void Screen::save_replay() const {
+        if (recorded_events.empty()) {
+            return;
+        }
+        Data::Replay recorded_replay;
+        recorded_replay.chart_hash = Data::chart_hash(*chart);
+        recorded_replay.audio_offset = audio_offset;
+        recorded_replay.song_folder = song_selection.song.folder;
+        recorded_replay.difficulty = song_selection.difficulty;
+        recorded_replay.events = recorded_events;
+        auto now = std::time(nullptr);
+        char timestamp[32];
+        std::strftime(timestamp, sizeof(timestamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+        std::ostringstream name;
+        name << timestamp << "-" << std::hex << recorded_replay.chart_hash << ".replay";
+        auto path = preferences.jujube_path/"data"/"replays"/name.str();
+        try {
+            recorded_replay.save(path);
+            std::cout << "Saved replay to " << path << '\n';
+        } catch (const std::exception& e) {
+            std::cerr << "Could not save the replay : " << e.what() << '\n';
+        }
     }
 
     void Screen::draw_debug() {
         if (ImGui::Begin("Gameplay Debug")) {
             if (ImGui::CollapsingHeader("Metrics")) {
-                ImGui::Text("Combo : %zu", combo);
+                const auto& snapshot = grading_snapshots.read_buffer();
+                ImGui::Text("Combo : %zu", snapshot.combo);
+                ImGui::Text("Dropped window events : %zu", events_queue.get_overflow_count());
+                ImGui::Text("Dropped button highlight events : %zu", dropped_button_highlight_events.load());
+                ImGui::Text("Frame time : %.3f ms", average_frame_time_ms);
+                ImGui::Text("Marker draw calls : %zu", marker_draw_calls);
+                ImGui::Text("Marker sprites : %zu", marker_sprite_count);
+                if (auto clock_stats = music->get_clock_stats()) {
+                    if (ImGui::TreeNode("Audio Clock")) {
+                        ImGui::Text("Samples         : %zu", clock_stats->sample_count);
+                        ImGui::Text("Jitter          : %.3f ms", clock_stats->jitter_ms);
+                        ImGui::Text("Drift           : %.1f ppm", clock_stats->drift_ppm);
+                        ImGui::Text("Last correction : %.3f ms", clock_stats->last_correction_ms);
+                        ImGui::TreePop();
+                    }
+                }
                 if (ImGui::TreeNode("Score")) {
-                    ImGui::Text("Raw           : %d", score.get_score());
-                    ImGui::Text("Final         : %d", score.get_final_score());
-                    ImGui::Text("Shutter value : %d", score.shutter);
+                    ImGui::Text("Raw           : %d", snapshot.score);
+                    ImGui::Text("Final         : %d", snapshot.final_score);
+                    ImGui::Text("Shutter value : %d", snapshot.shutter);
                     if (ImGui::TreeNode("Judgement Counts")) {
-                        ImGui::Text("PERFECT : %zu", score.judgement_counts.at(Data::Judgement::Perfect));
-                        ImGui::Text("GREAT   : %zu", score.judgement_counts.at(Data::Judgement::Great));
-                        ImGui::Text("GOOD    : %zu", score.judgement_counts.at(Data::Judgement::Good));
-                        ImGui::Text("POOR    : %zu", score.judgement_counts.at(Data::Judgement::Poor));
-                        ImGui::Text("MISS    : %zu", score.judgement_counts.at(Data::Judgement::Miss));
+                        ImGui::Text("PERFECT : %zu", snapshot.judgement_counts[0]);
+                        ImGui::Text("GREAT   : %zu", snapshot.judgement_counts[1]);
+                        ImGui::Text("GOOD    : %zu", snapshot.judgement_counts[2]);
+                        ImGui::Text("POOR    : %zu", snapshot.judgement_counts[3]);
+                        ImGui::Text("MISS    : %zu", snapshot.judgement_counts[4]);
                         ImGui::TreePop();
                     }
                     ImGui::TreePop();
@@ -726,6 +769,13 @@ namespace Gameplay {
                 if (ImGui::Button(display_black_bars?"shown":"hidden")) {
                     display_black_bars = not display_black_bars;
                 }
+                ImGui::NextColumn();
+                ImGui::TextUnformatted("marker batching"); ImGui::NextColumn();
+                if (ImGui::Button(batch_markers?"on":"off")) {
+                    batch_markers = not batch_markers;
+                }
+                ImGui::NextColumn();
+                ImGui::Columns(1);
             }
         }
         ImGui::End();
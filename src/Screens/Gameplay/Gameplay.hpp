@@ -1,27 +1,39 @@
 #pragma once
 
+#include <array>
 #include <atomic>
-#include <deque>
-#include <functional>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <tuple>
+#include <utility>
 #include <unordered_map>
+#include <vector>
 
 #include <SFML/Graphics.hpp>
 
 #include "../../Data/Chart.hpp"
 #include "../../Data/GradedNote.hpp"
 #include "../../Data/Note.hpp"
+#include "../../Data/Replay.hpp"
 #include "../../Data/Song.hpp"
 #include "../../Data/Score.hpp"
 #include "../../Drawables/GradedDensityGraph.hpp"
+#include "../../Drawables/HUDText.hpp"
 #include "../../Resources/Marker.hpp"
+#include "../../Resources/MarkerAtlas.hpp"
 #include "../../Input/Buttons.hpp"
+#include "../../Input/EvdevInput.hpp"
 #include "../../Input/Events.hpp"
 #include "../../Toolkit/AffineTransform.hpp"
 #include "../../Toolkit/Debuggable.hpp"
+#include "../../Toolkit/SPSCRingBuffer.hpp"
+#include "../../Toolkit/SpriteBatch.hpp"
+#include "../../Toolkit/TripleBuffer.hpp"
 #include "AbstractMusic.hpp"
+#include "ChartPreparation.hpp"
 #include "Resources.hpp"
+#include "Simulation.hpp"
 #include "TimedEventsQueue.hpp"
 #include "Drawables/Cursor.hpp"
 #include "Drawables/Shutter.hpp"
@@ -32,19 +44,54 @@ namespace Gameplay {
         Data::AbstractScore& score;
     };
 
+    // What the render thread needs to know about the grading,
+    // published by the input thread after every pass
+    struct GradingSnapshot {
+        // long notes that left the visible range then the visible notes, oldest first
+        std::vector<Data::GradedNote> notes;
+        std::size_t combo = 0;
+        int score = 0;
+        int final_score = 0;
+        int shutter = 0;
+        std::array<std::size_t, 5> judgement_counts = {};
+        // how many entries of Simulation::get_density_graph_grades() are written
+        std::size_t density_graph_grade_count = 0;
+    };
+
+    // Input events are polled, judged and graded on the thread that runs play_chart (the window's thread,
+    // SFML only lets it poll events) while another thread draws from the latest GradingSnapshot
     class Screen : public Toolkit::Debuggable, public HoldsResources {
     public:
-        explicit Screen(const Data::SongDifficulty& song_selection, ScreenResources& t_resources);
+        // With a replay, button events come from it instead of the player
+        Screen(
+            const Data::SongDifficulty& song_selection,
+            PreparedChart t_prepared_chart,
+            ScreenResources& t_resources,
+            std::optional<Data::Replay> t_replay = {}
+        );
         DetailedScore play_chart(sf::RenderWindow& window);
     private:
         void draw_debug() override;
         void render(sf::RenderWindow& window);
-        // Draw a normal note on marker_layer
+        // Queue a normal note in marker_batch
         void draw_tap_note(const Data::GradedNote& note, const sf::Time& music_time);
-        // Draw the long note tail on ln_tail_layer and its markers on marker_layer
+        // Queue the long note tail in ln_tail_batch, its tip and background in ln_note_batch
+        // and its markers in marker_batch
         void draw_long_note(const Data::GradedNote& note, const sf::Time& music_time);
-
-        void handle_raw_input_event(const Input::RawEvent& raw_event, const sf::Time& music_time);
+        void draw_marker_sprite(Toolkit::SpriteBatch& batch, const sf::Sprite& sprite);
+
+        // Input thread
+        void handle_input_event(const sf::Event& event, const sf::Time& music_time);
+        // returns false if the key is not mapped to a button
+        bool handle_raw_input_event(const Input::RawEvent& raw_event, const sf::Time& music_time);
+        // Judges the keys read by evdev_input at the music time they were actually hit at
+        // (music_time and now_us are sampled at the same moment)
+        void handle_evdev_events(const sf::Time& music_time, std::int64_t now_us);
+        // true if this key already reaches us through evdev_input
+        bool read_by_evdev(const sf::Keyboard::Key& key) const;
+        void publish_grading_snapshot();
+        // Render thread, for events that have nothing to do with the buttons
+        void handle_window_event(sf::RenderWindow& window, const sf::Event& event);
         
         std::optional<Input::Button> button_from_position(sf::Vector2i position);
         std::optional<Input::Button> last_mouse_clicked_button;
@@ -58,14 +105,16 @@ namespace Gameplay {
         void handle_touch_ended(const sf::Event::TouchEvent& touch_event, const sf::Time& music_time);
         
         void handle_button_event(const Input::ButtonEvent& button_event, const sf::Time& music_time);
-        void handle_button_press(const Input::Button& button, const sf::Time& music_time);
-        void handle_button_release(const Input::Button& button, const sf::Time& music_time);
 
         const Data::SongDifficulty& song_selection;
-        const Data::Chart chart;
+        const std::shared_ptr<const Data::Chart> chart;
         const Resources::Marker& marker;
         const Resources::LNMarker& ln_marker;
+        // marker sprites are moved onto it before being drawn
+        const Resources::MarkerAtlas& marker_atlas;
         std::unique_ptr<AbstractMusic> music;
+        // only set if the evdev_input option is on
+        std::unique_ptr<Input::EvdevInput> evdev_input;
         Drawables::GradedDensityGraph graded_density_graph;
         Drawables::Cursor cursor;
         Drawables::Shutter shutter;
@@ -73,25 +122,54 @@ namespace Gameplay {
         // maps music time to [0, 1]
         Toolkit::AffineTransform<float> music_time_to_progression;
 
-        std::deque<Data::GradedNote> notes;
-        std::deque<std::reference_wrapper<Data::GradedNote>> visible_notes;
-        void miss_old_notes(const sf::Time& music_time);
-        void release_finished_longs(const sf::Time& music_time);
-        // Performs passive grading actions (misses and long note releases)
-        // Then update the visible notes
-        void update_visible_notes(const sf::Time& music_time);
-
-        sf::RenderTexture ln_tail_layer;
-        sf::RenderTexture marker_layer;
-
-        Data::ClassicScore score;
-        std::size_t combo = 0;
+        // judgement, score and combo, only touched by the input thread
+        Simulation simulation;
+
+        std::optional<Data::Replay> replay;
+        std::size_t next_replay_event = 0;
+        // Feeds the replay events that happened before music_time
+        void play_replay_events(const sf::Time& music_time);
+        // the replay's when playing one back, the one from the preferences otherwise
+        const sf::Time audio_offset;
+        // every button event judged, saved to data/replays at the end
+        std::vector<Data::ReplayEvent> recorded_events;
+        void save_replay() const;
+
+        // render thread side, built once and only updated when their text changes
+        Drawables::HUDText combo_text;
+        Drawables::HUDText score_text;
+        Drawables::HUDText song_title_label;
+        Drawables::HUDText song_artist_label;
+        Drawables::HUDText level_label;
+        Drawables::HUDText level_number_label;
+        Drawables::HUDText chart_label;
+
+        // the markers of a frame, drawn in one call per texture.
+        // A batch does not keep the order between textures so each layer gets its own
+        Toolkit::SpriteBatch ln_tail_batch;
+        Toolkit::SpriteBatch ln_note_batch;
+        Toolkit::SpriteBatch marker_batch;
+
+        // render thread side
+        std::size_t applied_density_graph_grades = 0;
+        void apply_density_graph_grades(std::size_t count);
+
+        Toolkit::TripleBuffer<GradingSnapshot> grading_snapshots;
 
         std::atomic<bool> song_finished = false;
 
+        // window events for the render thread : close, resize and keys not mapped to a button
         TimedEventsQueue events_queue;
+        // button presses and releases for the button highlight, dropped if the render thread lags behind
+        Toolkit::SPSCRingBuffer<Input::ButtonEvent, 256> button_highlight_events;
+        std::atomic<std::size_t> dropped_button_highlight_events = 0;
 
         bool display_black_bars = true;
+        // turned off from the debug window to compare with drawing every sprite on its own
+        bool batch_markers = true;
+        std::size_t marker_draw_calls = 0;
+        std::size_t marker_sprite_count = 0;
+        float average_frame_time_ms = 0.f;
     };
 
     Toolkit::AffineTransform<float> get_music_time_to_progression_transform(const Data::SongDifficulty& song_selection);
@@ -0,0 +1,165 @@
+#include "Simulation.hpp"
+
+#include <algorithm>
+
+namespace Gameplay {
+    namespace {
+        // Notes are on screen from this long before their timing to this long after
+        const sf::Time visibility_window = sf::seconds(16.f/30.f);
+    }
+
+    Simulation::Simulation(const Data::Chart& chart) :
+        last_event_timing(chart.get_last_event_timing()),
+        score(chart.notes)
+    {
+        notes.reserve(chart.notes.size());
+        for (auto&& note : chart.notes) {
+            notes.emplace_back(Data::GradedNote{note});
+        }
+        lingering_longs.reserve(chart.notes.long_note_count());
+        for (std::size_t button = 0; button < lanes.size(); button++) {
+            const auto& indices = chart.notes.notes_on(static_cast<Input::Button>(button));
+            lanes[button].notes.assign(indices.begin(), indices.end());
+        }
+        density_graph_grades.resize(Data::count_classic_scoring_events(chart.notes));
+    }
+
+    void Simulation::handle_button_event(const Input::ButtonEvent& button_event, const sf::Time& music_time) {
+        switch (button_event.type) {
+        case Input::EventType::Pressed:
+            handle_button_press(button_event.button, music_time);
+            break;
+        case Input::EventType::Released:
+            handle_button_release(button_event.button, music_time);
+            break;
+        }
+    }
+
+    void Simulation::play(const std::vector<TimedButtonEvent>& events) {
+        for (const auto& [time, event] : events) {
+            update(time);
+            handle_button_event(event, time);
+        }
+        finish();
+    }
+
+    void Simulation::finish() {
+        update(last_event_timing + visibility_window + sf::microseconds(1));
+    }
+
+    void Simulation::handle_button_press(const Input::Button& button, const sf::Time& music_time) {
+        auto& lane = lanes.at(Input::button_to_index(button));
+        // skip what has been graded by other means since (misses)
+        while (lane.next_ungraded < lane.notes.size() and notes[lane.notes[lane.next_ungraded]].tap_judgement) {
+            lane.next_ungraded++;
+        }
+        if (lane.next_ungraded >= lane.notes.size()) {
+            return;
+        }
+        // only notes that are already on screen can be hit
+        auto note_index = lane.notes[lane.next_ungraded];
+        if (note_index >= visible_end) {
+            return;
+        }
+        lane.next_ungraded++;
+        auto& note = notes[note_index];
+        note = Data::GradedNote{note, music_time-note.timing};
+        auto& judgement = note.tap_judgement->judgement;
+        record_grade(judgement, note.timing);
+        if (Data::judgement_breaks_combo(judgement)) {
+            // If we've broken combo at the begining of a long we also missed the end
+            if (note.duration > sf::Time::Zero) {
+                note.long_release = Data::TimedJudgement{sf::Time::Zero, Data::Judgement::Miss};
+                record_grade(Data::Judgement::Miss, note.timing+note.duration);
+            }
+            combo = 0;
+        } else {
+            if (note.duration > sf::Time::Zero) {
+                lane.held_long = note_index;
+            }
+            combo++;
+        }
+    }
+
+    void Simulation::handle_button_release(const Input::Button& button, const sf::Time& music_time) {
+        auto& lane = lanes.at(Input::button_to_index(button));
+        if (not lane.held_long) {
+            return;
+        }
+        auto& note = notes[*lane.held_long];
+        lane.held_long.reset();
+        // has it already been graded for release ? (it ended while still held)
+        if (note.long_release) {
+            return;
+        }
+        auto timed_judgement = Data::TimedJudgement{music_time-note.timing-note.duration};
+        note.long_release = timed_judgement;
+        record_grade(timed_judgement.judgement, note.timing+note.duration);
+        if (Data::judgement_breaks_combo(timed_judgement.judgement)) {
+            combo = 0;
+        } else {
+            combo++;
+        }
+    }
+
+    void Simulation::update(const sf::Time& music_time) {
+        if (not latest_update or *latest_update < music_time) {
+            latest_update = music_time;
+        }
+        const auto window = visibility_window;
+        // Notes coming in
+        while (visible_end < notes.size() and notes[visible_end].timing <= music_time + window) {
+            visible_end++;
+        }
+        // Notes going out, what has not been hit by now is missed
+        while (visible_begin < visible_end and notes[visible_begin].timing < music_time - window) {
+            auto& note = notes[visible_begin];
+            if (not note.tap_judgement) {
+                auto timed_judgement = Data::TimedJudgement{sf::Time::Zero, Data::Judgement::Miss};
+                note.tap_judgement = timed_judgement;
+                record_grade(Data::Judgement::Miss, note.timing);
+                if (note.duration > sf::Time::Zero) {
+                    note.long_release = timed_judgement;
+                    record_grade(Data::Judgement::Miss, note.timing+note.duration);
+                }
+                combo = 0;
+            }
+            if (note.timing + note.duration >= music_time - window) {
+                lingering_longs.push_back(visible_begin);
+            }
+            visible_begin++;
+        }
+        lingering_longs.erase(
+            std::remove_if(lingering_longs.begin(), lingering_longs.end(),
+                [&](std::size_t index){
+                    return notes[index].timing + notes[index].duration < music_time - window;
+                }
+            ),
+            lingering_longs.end()
+        );
+        // Long notes held until the end are released automatically
+        for (auto& lane : lanes) {
+            if (not lane.held_long) {
+                continue;
+            }
+            auto& note = notes[*lane.held_long];
+            if (note.timing + note.duration < music_time) {
+                lane.held_long.reset();
+                if (not note.long_release) {
+                    auto timed_judgement = Data::TimedJudgement{sf::Time::Zero, Data::Judgement::Perfect};
+                    note.long_release = timed_judgement;
+                    record_grade(timed_judgement.judgement, note.timing + note.duration);
+                    combo++;
+                }
+            }
+        }
+    }
+
+    void Simulation::record_grade(Data::Judgement judgement, const sf::Time& timing) {
+        score.update(judgement);
+        if (density_graph_grade_count < density_graph_grades.size()) {
+            density_graph_grades[density_graph_grade_count] = {judgement, timing};
+            density_graph_grade_count++;
+        }
+    }
+}
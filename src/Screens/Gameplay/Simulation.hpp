@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Time.hpp>
+
+#include "../../Data/Chart.hpp"
+#include "../../Data/GradedNote.hpp"
+#include "../../Data/Score.hpp"
+#include "../../Input/Buttons.hpp"
+#include "../../Input/Events.hpp"
+
+namespace Gameplay {
+    struct TimedButtonEvent {
+        sf::Time time;
+        Input::ButtonEvent event;
+    };
+
+    // Judgement, scoring and combo for one play of a chart, without any window, music or drawing.
+    // Given the same button events and the same calls to update() it always grades the same way
+    class Simulation {
+    public:
+        explicit Simulation(const Data::Chart& chart);
+
+        void handle_button_event(const Input::ButtonEvent& button_event, const sf::Time& music_time);
+        // Moves the visible range forward, notes are marked as missed as they leave it,
+        // then releases the long notes held until the end
+        void update(const sf::Time& music_time);
+        // Plays events sorted by time, updating in between, then plays the rest of the chart
+        void play(const std::vector<TimedButtonEvent>& events);
+        // Lets time pass until every note is graded
+        void finish();
+
+        // same order as the chart's notes
+        const std::vector<Data::GradedNote>& get_notes() const {return notes;};
+        // The notes in [visible_begin, visible_end) are on screen
+        std::size_t get_visible_begin() const {return visible_begin;};
+        std::size_t get_visible_end() const {return visible_end;};
+        // Long notes that left the visible range but whose tail is still on screen
+        const std::vector<std::size_t>& get_lingering_longs() const {return lingering_longs;};
+        std::size_t get_combo() const {return combo;};
+        const Data::ClassicScore& get_score() const {return score;};
+        Data::ClassicScore& get_score() {return score;};
+        // Every grade given so far in order, for the graded density graph.
+        // Sized upfront for every scoring event of the chart so another thread
+        // can read the first get_density_graph_grade_count() entries while new ones are written
+        const std::vector<std::pair<Data::Judgement, sf::Time>>& get_density_graph_grades() const {return density_graph_grades;};
+        std::size_t get_density_graph_grade_count() const {return density_graph_grade_count;};
+        // Latest time given to update(), empty before the first call
+        std::optional<sf::Time> get_latest_update() const {return latest_update;};
+    private:
+        void handle_button_press(const Input::Button& button, const sf::Time& music_time);
+        void handle_button_release(const Input::Button& button, const sf::Time& music_time);
+        void record_grade(Data::Judgement judgement, const sf::Time& timing);
+
+        sf::Time last_event_timing;
+        std::optional<sf::Time> latest_update;
+
+        std::vector<Data::GradedNote> notes;
+        // both indices only ever move forward
+        std::size_t visible_begin = 0;
+        std::size_t visible_end = 0;
+        std::vector<std::size_t> lingering_longs;
+        // Notes of a single button, so judging a press does not have to look at the others
+        struct Lane {
+            // indices in notes, in timing order
+            std::vector<std::size_t> notes;
+            // every note before this one has been graded
+            std::size_t next_ungraded = 0;
+            // long note currently held down on this button
+            std::optional<std::size_t> held_long;
+        };
+        std::array<Lane, 16> lanes;
+
+        Data::ClassicScore score;
+        std::size_t combo = 0;
+
+        std::vector<std::pair<Data::Judgement, sf::Time>> density_graph_grades;
+        std::size_t density_graph_grade_count = 0;
+    };
+}
@@ -1,26 +1,32 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
+#include <cstddef>
 #include <optional>
-#include <queue>
 
 #include <SFML/System/Time.hpp>
 #include <SFML/Window/Event.hpp>
 
+#include "../../Toolkit/SPSCRingBuffer.hpp"
+
 namespace Gameplay {
     struct TimedEvent {
         sf::Time time;
         sf::Event event;
     };
 
-    // Thread-safe queue for events with a timestamp
+    // Lock-free queue for events with a timestamp,
+    // only one thread may push and only one thread may pop
     class TimedEventsQueue {
     public:
         TimedEventsQueue() = default;
+        // Drops the event if the queue is full
         void push(const TimedEvent& te);
         std::optional<TimedEvent> pop();
+        // Number of events dropped because the queue was full
+        std::size_t get_overflow_count() const {return m_overflow_count;};
     private:
-        std::queue<TimedEvent> m_queue;
-        std::mutex m_mutex;
+        Toolkit::SPSCRingBuffer<TimedEvent, 1024> m_buffer;
+        std::atomic<std::size_t> m_overflow_count = 0;
     };
 }
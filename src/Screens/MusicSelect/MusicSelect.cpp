@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <iostream>
+#include <unordered_set>
 
 #include <imgui/imgui.h>
 #include <imgui/misc/cpp/imgui_stdlib.h>
@@ -13,7 +14,7 @@
 #include "Panels/Panel.hpp"
 #include "PanelLayout.hpp"
 
-MusicSelect::Screen::Screen(const Data::SongList& t_song_list, ScreenResources& t_resources) :
+MusicSelect::Screen::Screen(Data::SongList& t_song_list, ScreenResources& t_resources) :
     HoldsResources(t_resources),
     song_list(t_song_list),
     ribbon(PanelLayout::title_sort(t_song_list, t_resources), t_resources),
@@ -23,6 +24,10 @@ MusicSelect::Screen::Screen(const Data::SongList& t_song_list, ScreenResources&
     start_button(t_resources)
 {
     panel_filter.setFillColor(sf::Color(0,0,0,200));
+    loading_label.setFont(shared.fallback_font.medium);
+    loading_label.setFillColor(sf::Color::White);
+    search_label.setFont(shared.fallback_font.medium);
+    search_label.setFillColor(sf::Color::White);
     std::cout << "loaded MusicSelect::Screen" << '\n';
 }
 
@@ -39,7 +44,14 @@ std::optional<Data::SongDifficulty> MusicSelect::Screen::select_chart(sf::Render
     panel_filter.setSize(sf::Vector2f{window.getSize()});
     options_button.setPosition(get_ribbon_x()+2.f*get_panel_step(), get_ribbon_y()+3.f*get_panel_step());
     start_button.setPosition(get_ribbon_x()+3.f*get_panel_step(), get_ribbon_y()+3.f*get_panel_step());
+    loading_label.setCharacterSize(static_cast<unsigned int>(0.2f*get_panel_size()));
+    loading_label.setPosition(get_ribbon_x(), get_ribbon_y()-0.3f*get_panel_size());
+    search_label.setCharacterSize(static_cast<unsigned int>(0.2f*get_panel_size()));
+    search_label.setPosition(get_ribbon_x(), get_ribbon_y()-0.6f*get_panel_size());
     while ((not chart_selected) and window.isOpen()) {
+        if (auto changes = song_list.update_from_disk()) {
+            apply_song_list_changes(*changes);
+        }
         sf::Event event;
         while (window.pollEvent(event)) {
             ImGui::SFML::ProcessEvent(event);
@@ -47,6 +59,9 @@ std::optional<Data::SongDifficulty> MusicSelect::Screen::select_chart(sf::Render
             case sf::Event::KeyPressed:
                 handle_key_press(event.key, window);
                 break;
+            case sf::Event::TextEntered:
+                handle_text_entered(event.text);
+                break;
             case sf::Event::MouseButtonPressed:
                 handle_mouse_click(event.mouseButton);
                 break;
@@ -60,12 +75,27 @@ std::optional<Data::SongDifficulty> MusicSelect::Screen::select_chart(sf::Render
                 break;
             }
         }
+        if (resources.selected_panel) {
+            if (auto selected_chart = resources.selected_panel->obj.get_selected_difficulty()) {
+                shared.chart_preparation.prepare(*selected_chart);
+            }
+        }
         ImGui::SFML::Update(window, imguiClock.restart());
         window.clear(sf::Color(7, 23, 53));
         window.draw(ribbon);
         window.draw(options_button);
         window.draw(start_button);
         window.draw(song_info);
+        if (song_list.is_loading()) {
+            loading_label.setString("Loading songs ... "+std::to_string(song_list.songs.size()));
+            window.draw(loading_label);
+        }
+        if (search_query) {
+            auto label = "Search : "+*search_query+(typing_search_query ? "_" : "");
+            label += "  ("+std::to_string(search_result_count)+" songs)";
+            search_label.setString(sf::String::fromUtf8(label.begin(), label.end()));
+            window.draw(search_label);
+        }
         if (not resources.options_state.empty()) {
             window.draw(panel_filter);
             window.draw(resources.options_state.back());
@@ -94,6 +124,102 @@ std::optional<Data::SongDifficulty> MusicSelect::Screen::select_chart(sf::Render
     }
 }
 
+void MusicSelect::Screen::apply_song_list_changes(const Data::SongListChanges& changes) {
+    for (const auto& song : changes.removed) {
+        shared.chart_preparation.forget(*song);
+        if (resources.selected_panel) {
+            auto selected = resources.selected_panel->obj.get_selected_difficulty();
+            if (selected and &selected->song == song.get()) {
+                resources.selected_panel->obj.unselect();
+                resources.selected_panel.reset();
+                resources.music_preview.stop();
+            }
+        }
+    }
+    ribbon.remove_songs({changes.removed.begin(), changes.removed.end()});
+    ribbon.add_songs({changes.added.begin(), changes.added.end()});
+    if (search_query) {
+        update_search_results();
+    }
+}
+
+void MusicSelect::Screen::handle_text_entered(const sf::Event::TextEvent& text_event) {
+    if (not typing_search_query) {
+        return;
+    }
+    // Control characters (backspace, enter ...) are dealt with as key presses
+    if (text_event.unicode < 32 or text_event.unicode == 127) {
+        return;
+    }
+    auto utf8 = sf::String{text_event.unicode}.toUtf8();
+    search_query->append(utf8.begin(), utf8.end());
+    update_search_results();
+}
+
+bool MusicSelect::Screen::handle_search_key_press(const sf::Event::KeyEvent& key_event) {
+    if (key_event.control and key_event.code == sf::Keyboard::F) {
+        if (not search_query) {
+            search_query.emplace();
+        }
+        typing_search_query = true;
+        return true;
+    }
+    if (not search_query) {
+        return false;
+    }
+    switch (key_event.code) {
+    case sf::Keyboard::Escape:
+        close_search();
+        return true;
+    case sf::Keyboard::Enter:
+        if (typing_search_query) {
+            // Keep the results but give the keys back to the buttons
+            typing_search_query = false;
+            return true;
+        }
+        break;
+    case sf::Keyboard::BackSpace:
+        if (typing_search_query and not search_query->empty()) {
+            // remove a whole UTF-8 sequence
+            while (not search_query->empty() and (static_cast<unsigned char>(search_query->back()) & 0xC0) == 0x80) {
+                search_query->pop_back();
+            }
+            if (not search_query->empty()) {
+                search_query->pop_back();
+            }
+            update_search_results();
+        }
+        break;
+    default:
+        break;
+    }
+    // Every other key is text while typing
+    return typing_search_query;
+}
+
+void MusicSelect::Screen::update_search_results() {
+    if (search_query->empty()) {
+        ribbon.show_full();
+        search_result_count = song_list.songs.size();
+        return;
+    }
+    sf::Clock search_clock;
+    auto results = song_list.search(*search_query);
+    last_search_duration = search_clock.getElapsedTime();
+    std::unordered_set<const Data::Song*> found_songs;
+    for (const auto& song : results) {
+        found_songs.insert(song.get());
+    }
+    search_result_count = found_songs.size();
+    ribbon.show_filtered(found_songs);
+}
+
+void MusicSelect::Screen::close_search() {
+    search_query.reset();
+    typing_search_query = false;
+    ribbon.show_full();
+}
+
 void MusicSelect::Screen::draw_debug(sf::RenderWindow& window) {
     if (debug) {
         if (ImGui::Begin("MusicSelect::Screen")) {
@@ -120,6 +246,11 @@ void MusicSelect::Screen::draw_debug(sf::RenderWindow& window) {
                     ImGui::TreePop();
                 }
             }
+            if (ImGui::CollapsingHeader("Search")) {
+                ImGui::Text("query        : %s", search_query ? search_query->c_str() : "- none -");
+                ImGui::Text("results      : %zu", search_result_count);
+                ImGui::Text("last search  : %lld us", static_cast<long long>(last_search_duration.asMicroseconds()));
+            }
             if (ImGui::CollapsingHeader("Options Menu Stack")) {
                 if (resources.options_state.empty()) {
                     ImGui::TextUnformatted("- empty -");
@@ -153,6 +284,9 @@ void MusicSelect::Screen::handle_key_press(const sf::Event::KeyEvent& key_event,
     if (output_used) {
         return;
     }
+    if (resources.options_state.empty() and handle_search_key_press(key_event)) {
+        return;
+    }
     auto button = shared.preferences.key_mapping.key_to_button(key_event.code);
     if (button) {
         press_button(*button);
@@ -271,4 +405,8 @@ void MusicSelect::Screen::Screen::update_view(sf::RenderWindow& window, sf::View
     }
     options_button.setPosition(get_ribbon_x()+2.f*get_panel_step(), get_ribbon_y()+3.f*get_panel_step());
     start_button.setPosition(get_ribbon_x()+3.f*get_panel_step(), get_ribbon_y()+3.f*get_panel_step());
+    loading_label.setCharacterSize(static_cast<unsigned int>(0.2f*get_panel_size()));
+    loading_label.setPosition(get_ribbon_x(), get_ribbon_y()-0.3f*get_panel_size());
+    search_label.setCharacterSize(static_cast<unsigned int>(0.2f*get_panel_size()));
+    search_label.setPosition(get_ribbon_x(), get_ribbon_y()-0.6f*get_panel_size());
 }
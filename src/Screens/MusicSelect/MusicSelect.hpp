@@ -3,6 +3,7 @@
 #include <map>
 #include <optional>
 #include <stack>
+#include <string>
 
 #include <SFML/Window.hpp>
 #include <SFML/Window/VideoMode.hpp>
@@ -25,13 +26,16 @@ namespace MusicSelect {
     class SongPanel;
     // The music select screen is created only once
     // it loads a cache of available songs in the song_list attribute
+    // and keeps it up to date with what happens in the songs folder
     class Screen : public Toolkit::Debuggable, public HoldsResources {
     public:
-        Screen(const Data::SongList& t_song_list, ScreenResources& t_resources);
+        Screen(Data::SongList& t_song_list, ScreenResources& t_resources);
         std::optional<Data::SongDifficulty> select_chart(sf::RenderWindow& window);
         void draw_debug(sf::RenderWindow& window);
     private:
-        const Data::SongList song_list;
+        Data::SongList& song_list;
+        // Songs added or removed from the songs folder while the game is running
+        void apply_song_list_changes(const Data::SongListChanges& changes);
 
         Ribbon ribbon;
         SongInfo song_info;
@@ -41,6 +45,20 @@ namespace MusicSelect {
         bool chart_selected = false;
 
         sf::RectangleShape panel_filter;
+        // shown while the songs are still being searched for
+        sf::Text loading_label;
+
+        // Ctrl+F starts typing a search query, Escape goes back to the full song list
+        std::optional<std::string> search_query;
+        bool typing_search_query = false;
+        sf::Text search_label;
+        std::size_t search_result_count = 0;
+        sf::Time last_search_duration;
+        void handle_text_entered(const sf::Event::TextEvent& text_event);
+        // returns true if the key was used by the search
+        bool handle_search_key_press(const sf::Event::KeyEvent& key_event);
+        void update_search_results();
+        void close_search();
     
         // converts a key press into a button press
         void handle_key_press(const sf::Event::KeyEvent& key_event, sf::RenderWindow& window);
@@ -1,5 +1,7 @@
 #include "PanelLayout.hpp"
 
+#include <algorithm>
+
 #include "Panels/Panel.hpp"
 
 namespace MusicSelect {
@@ -9,21 +11,9 @@ namespace MusicSelect {
     ) {
         for (auto &&[category, panels] : categories) {
             if (not panels.empty()) {
-                std::vector<std::shared_ptr<Panel>> current_column;
-                current_column.emplace_back(std::make_shared<CategoryPanel>(t_resources, category));
-                for (auto& panel : panels) {
-                    if (current_column.size() == 3) {
-                        push_back({current_column[0],current_column[1],current_column[2]});
-                        current_column.clear();
-                    }
-                    current_column.push_back(panel);
-                }
-                if (not current_column.empty()) {
-                    while (current_column.size() < 3) {
-                        current_column.emplace_back(std::make_shared<EmptyPanel>(t_resources));
-                    }
-                    push_back({current_column[0],current_column[1],current_column[2]});
-                }
+                auto columns = make_category_columns(std::make_shared<CategoryPanel>(t_resources, category), panels, t_resources);
+                insert(end(), columns.begin(), columns.end());
+                m_categories[category] = panels;
             }
         }
         fill_layout(t_resources);
@@ -58,6 +48,20 @@ namespace MusicSelect {
         return PanelLayout{panels, t_resources};
     }
 
+    namespace {
+        std::string title_sort_category(const Data::Song& song) {
+            if (song.title.size() > 0) {
+                char letter = song.title[0];
+                if ('A' <= letter and letter <= 'Z') {
+                    return std::string(1, letter);
+                } else if ('a' <= letter and letter <= 'z') {
+                    return std::string(1, 'A' + (letter - 'a'));
+                }
+            }
+            return "?";
+        }
+    }
+
     PanelLayout PanelLayout::title_sort(const Data::SongList& song_list, ScreenResources& t_resources) {
         std::vector<std::shared_ptr<const Data::Song>> songs;
         for (auto &&song : song_list.songs) {
@@ -70,28 +74,151 @@ namespace MusicSelect {
         );
         std::map<std::string, std::vector<std::shared_ptr<Panel>>> categories;
         for (const auto &song : songs) {
-            if (song->title.size() > 0) {
-                char letter = song->title[0];
-                if ('A' <= letter and letter <= 'Z') {
-                    categories
-                    [std::string(1, letter)]
-                    .emplace_back(std::make_shared<SongPanel>(t_resources, song));
-                } else if ('a' <= letter and letter <= 'z') {
-                    categories
-                    [std::string(1, 'A' + (letter - 'a'))]
-                    .emplace_back(std::make_shared<SongPanel>(t_resources, song));
-                } else {
-                    categories["?"].emplace_back(std::make_shared<SongPanel>(t_resources, song));
+            categories[title_sort_category(*song)].emplace_back(std::make_shared<SongPanel>(t_resources, song));
+        }
+        PanelLayout layout{categories, t_resources};
+        layout.m_sorted_by_title = true;
+        return layout;
+    }
+
+    void PanelLayout::insert_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs, ScreenResources& t_resources) {
+        if (not m_sorted_by_title) {
+            return;
+        }
+        std::map<std::string, std::size_t> old_column_counts;
+        for (const auto& song : songs) {
+            auto category = title_sort_category(*song);
+            auto& panels = m_categories[category];
+            old_column_counts.emplace(category, category_column_count(panels.size()));
+            auto position = std::find_if(
+                panels.begin(),
+                panels.end(),
+                [&](const std::shared_ptr<Panel>& panel){
+                    auto song_panel = std::dynamic_pointer_cast<SongPanel>(panel);
+                    return song_panel and Data::Song::sort_by_title(*song, *song_panel->get_song());
+                }
+            );
+            panels.insert(position, std::make_shared<SongPanel>(t_resources, song));
+        }
+        rebuild_categories(old_column_counts, t_resources);
+    }
+
+    void PanelLayout::remove_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs, ScreenResources& t_resources) {
+        if (not m_sorted_by_title) {
+            return;
+        }
+        std::map<std::string, std::size_t> old_column_counts;
+        for (const auto& song : songs) {
+            auto category = title_sort_category(*song);
+            auto it = m_categories.find(category);
+            if (it == m_categories.end()) {
+                continue;
+            }
+            auto& panels = it->second;
+            auto position = std::find_if(
+                panels.begin(),
+                panels.end(),
+                [&](const std::shared_ptr<Panel>& panel){
+                    auto song_panel = std::dynamic_pointer_cast<SongPanel>(panel);
+                    return song_panel and song_panel->get_song() == song;
                 }
-            } else {
-                categories["?"].emplace_back(std::make_shared<SongPanel>(t_resources, song));
+            );
+            if (position == panels.end()) {
+                continue;
+            }
+            old_column_counts.emplace(category, category_column_count(panels.size()));
+            m_removed_panels.push_back(*position);
+            panels.erase(position);
+        }
+        rebuild_categories(old_column_counts, t_resources);
+    }
+
+    PanelLayout PanelLayout::filtered(const std::unordered_set<const Data::Song*>& songs, ScreenResources& t_resources) const {
+        std::vector<std::shared_ptr<Panel>> panels;
+        for (const auto& column : *this) {
+            for (const auto& panel : column) {
+                auto song_panel = std::dynamic_pointer_cast<SongPanel>(panel);
+                if (song_panel and songs.find(song_panel->get_song().get()) != songs.end()) {
+                    panels.push_back(panel);
+                }
+            }
+        }
+        if (panels.empty()) {
+            return red_empty_layout(t_resources);
+        }
+        return PanelLayout{panels, t_resources};
+    }
+
+    std::vector<PanelLayout::Column> PanelLayout::make_category_columns(
+        const std::shared_ptr<Panel>& category_panel,
+        const std::vector<std::shared_ptr<Panel>>& panels,
+        ScreenResources& t_resources
+    ) {
+        std::vector<Column> columns;
+        std::vector<std::shared_ptr<Panel>> current_column;
+        current_column.push_back(category_panel);
+        for (auto& panel : panels) {
+            if (current_column.size() == 3) {
+                columns.push_back({current_column[0],current_column[1],current_column[2]});
+                current_column.clear();
             }
+            current_column.push_back(panel);
+        }
+        while (current_column.size() < 3) {
+            current_column.emplace_back(std::make_shared<EmptyPanel>(t_resources));
         }
-        return PanelLayout{categories, t_resources};
+        columns.push_back({current_column[0],current_column[1],current_column[2]});
+        return columns;
     }
-    
+
+    std::size_t PanelLayout::category_column_count(std::size_t panel_count) {
+        if (panel_count == 0) {
+            return 0;
+        }
+        // +1 for the category panel
+        return (panel_count + 1 + 2) / 3;
+    }
+
+    std::size_t PanelLayout::first_column_of(const std::string& category) const {
+        std::size_t column = 0;
+        for (auto &&[other_category, panels] : m_categories) {
+            if (other_category == category) {
+                break;
+            }
+            column += category_column_count(panels.size());
+        }
+        return column;
+    }
+
+    void PanelLayout::rebuild_categories(const std::map<std::string, std::size_t>& old_column_counts, ScreenResources& t_resources) {
+        erase(end() - static_cast<std::ptrdiff_t>(m_filler_columns), end());
+        m_filler_columns = 0;
+        // Going through categories in layout order means every category before
+        // the one being rebuilt already has its final number of columns
+        for (const auto& [category, old_column_count] : old_column_counts) {
+            auto first_column = static_cast<std::ptrdiff_t>(first_column_of(category));
+            std::vector<Column> columns;
+            const auto& panels = m_categories.at(category);
+            if (not panels.empty()) {
+                auto category_panel = (
+                    old_column_count > 0
+                    ? at(static_cast<std::size_t>(first_column))[0]
+                    : std::make_shared<CategoryPanel>(t_resources, category)
+                );
+                columns = make_category_columns(category_panel, panels, t_resources);
+            }
+            erase(begin() + first_column, begin() + first_column + static_cast<std::ptrdiff_t>(old_column_count));
+            insert(begin() + first_column, columns.begin(), columns.end());
+            if (panels.empty()) {
+                m_categories.erase(category);
+            }
+        }
+        fill_layout(t_resources);
+    }
+
     void PanelLayout::fill_layout(ScreenResources& t_resources) {
         while (size() < 4) {
+            m_filler_columns++;
             push_back({
                 std::make_shared<EmptyPanel>(t_resources),
                 std::make_shared<EmptyPanel>(t_resources),
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <array>
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "../../Data/Song.hpp"
@@ -21,7 +24,36 @@ namespace MusicSelect {
         static PanelLayout red_empty_layout(ScreenResources& t_resources);
         // Standard title sort with categories for each letter
         static PanelLayout title_sort(const Data::SongList& song_list, ScreenResources& t_resources);
+
+        // Add or remove songs from a title sorted layout,
+        // only the columns of the categories the songs belong to are rebuilt.
+        // Does nothing on layouts that are not title sorted
+        void insert_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs, ScreenResources& t_resources);
+        void remove_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs, ScreenResources& t_resources);
+        // Layout with only the panels of the given songs, in the same order as this one.
+        // The panels are shared with this layout so a selected song stays selected
+        PanelLayout filtered(const std::unordered_set<const Data::Song*>& songs, ScreenResources& t_resources) const;
     private:
+        using Column = std::array<std::shared_ptr<Panel>,3>;
+        // Category panel followed by the given panels, in columns of three
+        static std::vector<Column> make_category_columns(
+            const std::shared_ptr<Panel>& category_panel,
+            const std::vector<std::shared_ptr<Panel>>& panels,
+            ScreenResources& t_resources
+        );
+        static std::size_t category_column_count(std::size_t panel_count);
+        std::size_t first_column_of(const std::string& category) const;
+        // Replaces the old columns of the categories with ones matching their current panels,
+        // takes the category names mapped to how many columns they used to span
+        void rebuild_categories(const std::map<std::string, std::size_t>& old_column_counts, ScreenResources& t_resources);
         void fill_layout(ScreenResources& t_resources);
+
+        std::map<std::string,std::vector<std::shared_ptr<Panel>>> m_categories;
+        // empty columns added at the end by fill_layout
+        std::size_t m_filler_columns = 0;
+        // Panels of removed songs are kept alive, SongDifficulty objects handed out
+        // earlier (for instance the density graph cache keys) still reference their selected chart
+        std::vector<std::shared_ptr<Panel>> m_removed_panels;
+        bool m_sorted_by_title = false;
     };
 }
\ No newline at end of file
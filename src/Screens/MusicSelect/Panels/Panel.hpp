@@ -77,6 +77,7 @@ namespace MusicSelect {
         void click(Ribbon& ribbon, const Input::Button& button) override;
         void unselect() override;
         std::optional<Data::SongDifficulty> get_selected_difficulty() const override;
+        const std::shared_ptr<const Data::Song>& get_song() const {return m_song;};
     private:
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
         std::shared_ptr<const Data::Song> m_song;
@@ -149,6 +149,49 @@ namespace MusicSelect {
         }
     }
 
+    void Ribbon::add_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs) {
+        if (m_full_layout) {
+            m_full_layout->insert_songs(songs, resources);
+        } else {
+            m_layout.insert_songs(songs, resources);
+            clamp_position();
+        }
+    }
+
+    void Ribbon::remove_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs) {
+        if (m_full_layout) {
+            m_full_layout->remove_songs(songs, resources);
+        } else {
+            m_layout.remove_songs(songs, resources);
+            clamp_position();
+        }
+    }
+
+    void Ribbon::show_filtered(const std::unordered_set<const Data::Song*>& songs) {
+        if (not m_full_layout) {
+            m_full_layout.emplace(std::move(m_layout));
+            m_full_position = m_position;
+        }
+        m_layout = m_full_layout->filtered(songs, resources);
+        m_position = 0;
+        m_move_animation.reset();
+    }
+
+    void Ribbon::show_full() {
+        if (not m_full_layout) {
+            return;
+        }
+        m_layout = std::move(*m_full_layout);
+        m_full_layout.reset();
+        m_position = m_full_position;
+        clamp_position();
+    }
+
+    void Ribbon::clamp_position() {
+        m_position %= m_layout.size();
+        m_move_animation.reset();
+    }
+
     void Ribbon::draw(sf::RenderTarget &target, sf::RenderStates states) const {
         states.transform *= getTransform();
 
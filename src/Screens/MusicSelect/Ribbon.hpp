@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <optional>
+#include <unordered_set>
 
 #include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/Transformable.hpp>
@@ -47,6 +49,13 @@ namespace MusicSelect {
         void move_right();
         void move_left();
         void move_to_next_category(const Input::Button& button);
+        // Keep the ribbon in sync with songs added or removed while the game is running
+        void add_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs);
+        void remove_songs(const std::vector<std::shared_ptr<const Data::Song>>& songs);
+        // Temporarily replace what's shown by a subset of the songs (search results),
+        // the full layout is still kept up to date in the meantime
+        void show_filtered(const std::unordered_set<const Data::Song*>& songs);
+        void show_full();
         void draw_debug() override;
         virtual ~Ribbon() = default;
     protected:
@@ -55,8 +64,13 @@ namespace MusicSelect {
         void draw_with_animation(sf::RenderTarget& target, sf::RenderStates states) const;
         void draw_without_animation(sf::RenderTarget& target, sf::RenderStates states) const;
         std::size_t get_layout_column(const Input::Button& button) const;
+        // Called after the layout changed size
+        void clamp_position();
         mutable PanelLayout m_layout;
         std::size_t m_position = 0;
+        // Full layout and position to go back to while a filtered one is shown
+        std::optional<PanelLayout> m_full_layout;
+        std::size_t m_full_position = 0;
         mutable std::optional<MoveAnimation> m_move_animation;
         float m_time_factor = 1.f;
         mutable LeftButton left_button;
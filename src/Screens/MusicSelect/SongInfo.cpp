@@ -54,8 +54,23 @@ namespace MusicSelect {
 
     SongInfo::SongInfo(ScreenResources& t_resources) :
         HoldsResources(t_resources),
-        m_big_cover(resources)
-    {}
+        m_big_cover(resources),
+        m_song_title_label(shared.fallback_font.medium),
+        m_song_artist_label(shared.fallback_font.medium),
+        m_level_label(shared.fallback_font.light),
+        m_level_number_label(shared.fallback_font.black),
+        m_chart_label(shared.fallback_font.medium)
+    {
+        m_song_title_label.set_fill_color(sf::Color::White);
+        m_song_artist_label.set_style(sf::Text::Italic);
+        m_song_artist_label.set_fill_color(sf::Color::White);
+        m_level_label.set_string("LEVEL");
+        m_level_label.set_fill_color(sf::Color::White);
+        m_level_label.set_origin_normalized(0.5f, 0.f);
+        m_level_number_label.set_fill_color(sf::Color::White);
+        m_level_number_label.set_origin_normalized(0.5f, 0.f);
+        m_chart_label.set_origin_normalized_no_position(0.5f, 0.f);
+    }
 
     void SongInfo::draw(sf::RenderTarget& target, sf::RenderStates states) const {
         states.transform *= getTransform();
@@ -77,46 +92,43 @@ namespace MusicSelect {
         if (not selected_chart.has_value()) {
             return;
         }
-        auto song_title = selected_chart->song.title;
-        if (not song_title.empty()) {
-            sf::Text song_title_label{
-                sf::String::fromUtf8(song_title.begin(), song_title.end()),
-                shared.fallback_font.medium,
+        m_song_title_label.set_string(selected_chart->song.title);
+        if (not m_song_title_label.empty()) {
+            m_song_title_label.set_character_size(
                 static_cast<unsigned int>(
                     0.026315789f*get_screen_width()
                 )
-            };
-            auto song_title_bounds = song_title_label.getLocalBounds();
+            );
+            auto song_title_bounds = m_song_title_label.get_local_bounds();
             if (song_title_bounds.width > m_big_cover.get_size()) {
-                song_title_label.setScale(m_big_cover.get_size() / song_title_bounds.width, 1.0f);
+                m_song_title_label.setScale(m_big_cover.get_size() / song_title_bounds.width, 1.0f);
+            } else {
+                m_song_title_label.setScale(1.0f, 1.0f);
             }
-            song_title_label.setFillColor(sf::Color::White);
-            song_title_label.setPosition(
+            m_song_title_label.setPosition(
                 get_big_cover_x() - m_big_cover.get_size()/2.f,
                 get_big_cover_y() + m_big_cover.get_size() + 0.01f*get_screen_width()
             );
-            target.draw(song_title_label, states);
+            target.draw(m_song_title_label, states);
         }
-        auto song_artist = selected_chart->song.artist;
-        if (not song_artist.empty()) {
-            sf::Text song_artist_label{
-                sf::String::fromUtf8(song_artist.begin(), song_artist.end()),
-                shared.fallback_font.medium,
+        m_song_artist_label.set_string(selected_chart->song.artist);
+        if (not m_song_artist_label.empty()) {
+            m_song_artist_label.set_character_size(
                 static_cast<unsigned int>(
                     0.02f*get_screen_width()
                 )
-            };
-            song_artist_label.setStyle(sf::Text::Italic);
-            auto song_artist_bounds = song_artist_label.getLocalBounds();
+            );
+            auto song_artist_bounds = m_song_artist_label.get_local_bounds();
             if (song_artist_bounds.width > m_big_cover.get_size()) {
-                song_artist_label.setScale(m_big_cover.get_size() / song_artist_bounds.width, 1.0f);
+                m_song_artist_label.setScale(m_big_cover.get_size() / song_artist_bounds.width, 1.0f);
+            } else {
+                m_song_artist_label.setScale(1.0f, 1.0f);
             }
-            song_artist_label.setFillColor(sf::Color::White);
-            song_artist_label.setPosition(
+            m_song_artist_label.setPosition(
                 get_big_cover_x() - m_big_cover.get_size()/2.f,
                 get_big_cover_y() + m_big_cover.get_size() + 0.04f*get_screen_width()
             );
-            target.draw(song_artist_label, states);
+            target.draw(m_song_artist_label, states);
         }
     }
 
@@ -129,25 +141,14 @@ namespace MusicSelect {
         if (not selected_chart.has_value()) {
             return;
         }
-        sf::Text level_label{
-            "LEVEL",
-            shared.fallback_font.light,
-            static_cast<unsigned int>(12.f/768.f*get_screen_width())
-        };
-        Toolkit::set_origin_normalized(level_label, 0.5f, 0.f);
-        level_label.setPosition(get_big_level_x(), get_big_level_y());
-        level_label.setFillColor(sf::Color::White);
-        target.draw(level_label, states);
-        
-        sf::Text level_number_label{
-            std::to_string(selected_chart->song.chart_levels.at(selected_chart->difficulty)),
-            shared.fallback_font.black,
-            static_cast<unsigned int>(130.f/768.f*get_screen_width())
-        };
-        Toolkit::set_origin_normalized(level_number_label, 0.5f, 0.f);
-        level_number_label.setPosition(get_big_level_x(), get_big_level_y()+(30.f/768.f*get_screen_width()));
-        level_number_label.setFillColor(sf::Color::White);
-        target.draw(level_number_label, states);
+        m_level_label.set_character_size(static_cast<unsigned int>(12.f/768.f*get_screen_width()));
+        m_level_label.setPosition(get_big_level_x(), get_big_level_y());
+        target.draw(m_level_label, states);
+
+        m_level_number_label.set_number(selected_chart->song.chart_levels.at(selected_chart->difficulty));
+        m_level_number_label.set_character_size(static_cast<unsigned int>(130.f/768.f*get_screen_width()));
+        m_level_number_label.setPosition(get_big_level_x(), get_big_level_y()+(30.f/768.f*get_screen_width()));
+        target.draw(m_level_number_label, states);
 
         std::string full_difficulty = selected_chart->difficulty;
         if (selected_chart->difficulty == "BSC") {
@@ -158,15 +159,11 @@ namespace MusicSelect {
             full_difficulty = "EXTREME";
         }
 
-        sf::Text chart_label{
-            sf::String::fromUtf8(full_difficulty.begin(), full_difficulty.end()),
-            shared.fallback_font.medium,
-            static_cast<unsigned int>(20.f/768.f*get_screen_width())
-        };
-        Toolkit::set_origin_normalized_no_position(chart_label, 0.5f, 0.f);
-        chart_label.setPosition(get_big_level_x(), get_big_level_y()+(145.f/768.f*get_screen_width()));
-        chart_label.setFillColor(shared.get_chart_color(selected_chart->difficulty));
-        target.draw(chart_label, states);
+        m_chart_label.set_string(full_difficulty);
+        m_chart_label.set_character_size(static_cast<unsigned int>(20.f/768.f*get_screen_width()));
+        m_chart_label.setPosition(get_big_level_x(), get_big_level_y()+(145.f/768.f*get_screen_width()));
+        m_chart_label.set_fill_color(shared.get_chart_color(selected_chart->difficulty));
+        target.draw(m_chart_label, states);
     }
 
     void MusicSelect::SongInfo::draw_chart_list(sf::RenderTarget& target, sf::RenderStates states) const {
@@ -3,6 +3,7 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 
+#include "../../Drawables/HUDText.hpp"
 #include "../../Toolkit/AffineTransform.hpp"
 
 #include "Resources.hpp"
@@ -30,6 +31,12 @@ namespace MusicSelect {
         void draw_chart_list(sf::RenderTarget& target, sf::RenderStates states) const;
         void draw_density_graph(sf::RenderTarget& target, sf::RenderStates states) const;
         mutable BigCover m_big_cover;
+        // only rebuilt when the selected chart changes
+        mutable Drawables::HUDText m_song_title_label;
+        mutable Drawables::HUDText m_song_artist_label;
+        mutable Drawables::HUDText m_level_label;
+        mutable Drawables::HUDText m_level_number_label;
+        mutable Drawables::HUDText m_chart_label;
         const Toolkit::AffineTransform<float> m_seconds_to_badge_anim{0.f, 0.15f, 0.f, 1.f};
     };
 }
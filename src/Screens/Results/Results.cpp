@@ -14,17 +14,51 @@ namespace Results {
         HoldsResources(t_resources),
         graded_density_graph(t_graded_density_graph),
         song_selection(t_song_selection),
-        chart(*t_song_selection.get_chart()),
-        score(t_score)
+        chart(t_song_selection.get_chart()),
+        score(t_score),
+        score_text(t_resources.shared.fallback_font.black),
+        rating_text(t_resources.shared.fallback_font.black),
+        song_title_label(t_resources.shared.fallback_font.medium),
+        song_artist_label(t_resources.shared.fallback_font.medium),
+        level_label(t_resources.shared.fallback_font.medium),
+        level_number_label(t_resources.shared.fallback_font.black),
+        chart_label(t_resources.shared.fallback_font.medium)
     {
+        score_text.set_number(score.get_final_score());
+        score_text.set_fill_color(sf::Color(29, 98, 226));
+        score_text.set_origin_normalized(1.f, 1.f);
+        rating_text.set_string(Data::rating_to_string.at(score.get_rating()));
+        rating_text.set_fill_color(sf::Color(29, 98, 226));
+        rating_text.set_origin_normalized(0.5f, 0.5f);
+        song_title_label.set_string(song_selection.song.title);
+        song_title_label.set_fill_color(sf::Color::White);
+        song_title_label.set_origin_normalized(0.f, 1.f);
+        song_artist_label.set_string(song_selection.song.artist);
+        song_artist_label.set_style(sf::Text::Italic);
+        song_artist_label.set_fill_color(sf::Color::White);
+        level_label.set_string("LEVEL:");
+        level_label.set_fill_color(sf::Color::White);
+        level_label.set_origin_normalized(1.f, 1.f);
+        level_number_label.set_number(chart->level);
+        level_number_label.set_fill_color(sf::Color::White);
+        level_number_label.set_origin_normalized(0.5f, 0.f);
+        std::string full_difficulty = song_selection.difficulty;
+        if (full_difficulty == "BSC") {
+            full_difficulty = "BASIC";
+        } else if (full_difficulty == "ADV") {
+            full_difficulty = "ADVANCED";
+        } else if (full_difficulty == "EXT") {
+            full_difficulty = "EXTREME";
+        }
+        chart_label.set_string(full_difficulty);
+        chart_label.set_fill_color(shared.get_chart_color(song_selection.difficulty));
+        chart_label.set_origin_normalized(1.f, 1.f);
     }
 
     void Screen::display(sf::RenderWindow& window) {
         window.setKeyRepeatEnabled(true);
         window.setActive(true);
         sf::Clock imgui_clock;
-        auto final_score = score.get_final_score();
-        auto final_rating = score.get_rating();
         while ((not should_exit) and window.isOpen()) {
             sf::Event event;
             while (window.pollEvent(event)) {
@@ -68,12 +102,7 @@ namespace Results {
             window.draw(graded_density_graph);
 
             // Draw score
-            sf::Text score_text;
-            score_text.setFont(shared.fallback_font.black);
-            score_text.setFillColor(sf::Color(29, 98, 226));
-            score_text.setString(std::to_string(final_score));
-            score_text.setCharacterSize(static_cast<unsigned int>(45.f/768.f*get_screen_width()));
-            Toolkit::set_local_origin_normalized(score_text, 1.f, 1.f);
+            score_text.set_character_size(static_cast<unsigned int>(45.f/768.f*get_screen_width()));
             score_text.setPosition(
                 500.f/768.f*get_screen_width(),
                 370.f/768.f*get_screen_width()
@@ -81,12 +110,7 @@ namespace Results {
             window.draw(score_text);
 
             // Draw Rating
-            sf::Text rating_text;
-            rating_text.setFont(shared.fallback_font.black);
-            rating_text.setFillColor(sf::Color(29, 98, 226));
-            rating_text.setString(Data::rating_to_string.at(final_rating));
-            rating_text.setCharacterSize(static_cast<unsigned int>(0.5f*get_panel_size()));
-            Toolkit::set_local_origin_normalized(rating_text, 0.5f, 0.5f);
+            rating_text.set_character_size(static_cast<unsigned int>(0.5f*get_panel_size()));
             rating_text.setPosition(
                 get_ribbon_x()+2.f*get_panel_step()+0.5*get_panel_size(),
                 get_ribbon_y()+2.f*get_panel_step()+0.5*get_panel_size()
@@ -94,67 +118,26 @@ namespace Results {
             window.draw(rating_text);
 
             // Draw song info
-            auto song_title = song_selection.song.title;
-            if (not song_title.empty()) {
-                sf::Text song_title_label{
-                    sf::String::fromUtf8(song_title.begin(), song_title.end()),
-                    shared.fallback_font.medium,
-                    static_cast<unsigned int>(scale(20.f))
-                };
-                Toolkit::set_local_origin_normalized(song_title_label, 0.f, 1.f);
-                song_title_label.setFillColor(sf::Color::White);
+            if (not song_title_label.empty()) {
+                song_title_label.set_character_size(static_cast<unsigned int>(scale(20.f)));
                 song_title_label.setPosition(scale(440.f), scale(40.f));
                 window.draw(song_title_label);
             }
-            auto song_artist = song_selection.song.artist;
-            if (not song_artist.empty()) {
-                sf::Text song_artist_label{
-                    sf::String::fromUtf8(song_artist.begin(), song_artist.end()),
-                    shared.fallback_font.medium,
-                    static_cast<unsigned int>(scale(12.f))
-                };
-                song_artist_label.setStyle(sf::Text::Italic);
-                song_artist_label.setFillColor(sf::Color::White);
+            if (not song_artist_label.empty()) {
+                song_artist_label.set_character_size(static_cast<unsigned int>(scale(12.f)));
                 song_artist_label.setPosition(scale(440.f), scale(45.f));
                 window.draw(song_artist_label);
             }
-            sf::Text level_label{
-                "LEVEL:",
-                shared.fallback_font.medium,
-                static_cast<unsigned int>(scale(10.f))
-            };
-            Toolkit::set_origin_normalized(level_label, 1.f, 1.f);
+            level_label.set_character_size(static_cast<unsigned int>(scale(10.f)));
             level_label.setPosition(scale(322.f), scale(35.f));
-            level_label.setFillColor(sf::Color::White);
             window.draw(level_label);
-            
-            sf::Text level_number_label{
-                std::to_string(chart.level),
-                shared.fallback_font.black,
-                static_cast<unsigned int>(scale(35.f))
-            };
-            Toolkit::set_origin_normalized(level_number_label, 0.5f, 0.f);
+
+            level_number_label.set_character_size(static_cast<unsigned int>(scale(35.f)));
             level_number_label.setPosition(scale(351.f), scale(24.f));
-            level_number_label.setFillColor(sf::Color::White);
             window.draw(level_number_label);
 
-            std::string full_difficulty = song_selection.difficulty;
-            if (full_difficulty == "BSC") {
-                full_difficulty = "BASIC";
-            } else if (full_difficulty == "ADV") {
-                full_difficulty = "ADVANCED";
-            } else if (full_difficulty == "EXT") {
-                full_difficulty = "EXTREME";
-            }
-
-            sf::Text chart_label{
-                sf::String::fromUtf8(full_difficulty.begin(), full_difficulty.end()),
-                shared.fallback_font.medium,
-                static_cast<unsigned int>(scale(16.f))
-            };
-            Toolkit::set_local_origin_normalized(chart_label, 1.f, 1.f);
+            chart_label.set_character_size(static_cast<unsigned int>(scale(16.f)));
             chart_label.setPosition(scale(322.f), scale(55.f));
-            chart_label.setFillColor(shared.get_chart_color(song_selection.difficulty));
             window.draw(chart_label);
 
             shared.button_highlight.update();
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 
 #include <SFML/Graphics.hpp>
 
 #include "../../Drawables/GradedDensityGraph.hpp"
+#include "../../Drawables/HUDText.hpp"
 #include "../../Data/GradedNote.hpp"
 #include "../../Data/Score.hpp"
 #include "../../Input/Events.hpp"
@@ -25,8 +27,16 @@ namespace Results {
     private:
         Drawables::GradedDensityGraph graded_density_graph;
         const Data::SongDifficulty& song_selection;
-        const Data::Chart& chart;
+        const std::shared_ptr<const Data::Chart> chart;
         const Data::AbstractScore& score;
+        // nothing on this screen changes once it's built, only the character sizes follow the window
+        Drawables::HUDText score_text;
+        Drawables::HUDText rating_text;
+        Drawables::HUDText song_title_label;
+        Drawables::HUDText song_artist_label;
+        Drawables::HUDText level_label;
+        Drawables::HUDText level_number_label;
+        Drawables::HUDText chart_label;
         bool should_exit = false;
 
         // converts a key press (keyboard or joystick) into a button press
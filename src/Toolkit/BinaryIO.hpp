@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Helpers to read and write the binary caches jujube keeps in its data folder
+// Values are stored in native byte order, files are not meant to be shared between machines
+namespace Toolkit {
+    template<typename T>
+    void write_binary(std::ostream& out, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "write_binary only works on trivially copyable types");
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    T read_binary(std::istream& in) {
+        static_assert(std::is_trivially_copyable_v<T>, "read_binary only works on trivially copyable types");
+        T value;
+        if (not in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            throw std::runtime_error("Unexpected end of file");
+        }
+        return value;
+    }
+
+    inline void write_binary_string(std::ostream& out, const std::string& s) {
+        write_binary<std::uint32_t>(out, static_cast<std::uint32_t>(s.size()));
+        out.write(s.data(), static_cast<std::streamsize>(s.size()));
+    }
+
+    inline std::string read_binary_string(std::istream& in) {
+        auto size = read_binary<std::uint32_t>(in);
+        std::string s(size, '\0');
+        if (not in.read(s.data(), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Unexpected end of file");
+        }
+        return s;
+    }
+
+    // Reads a value from memory instead of a stream, cursor is moved past it
+    template<typename T>
+    T read_binary(const char*& cursor, const char* end) {
+        static_assert(std::is_trivially_copyable_v<T>, "read_binary only works on trivially copyable types");
+        if (static_cast<std::size_t>(end - cursor) < sizeof(T)) {
+            throw std::runtime_error("Unexpected end of file");
+        }
+        T value;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+
+    inline std::string read_binary_string(const char*& cursor, const char* end) {
+        auto size = read_binary<std::uint32_t>(cursor, end);
+        if (static_cast<std::size_t>(end - cursor) < size) {
+            throw std::runtime_error("Unexpected end of file");
+        }
+        std::string s(cursor, size);
+        cursor += size;
+        return s;
+    }
+
+    // LEB128 : 7 bits per byte, small values take a single byte
+    inline void write_varint(std::ostream& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    inline std::uint64_t read_varint(const char*& cursor, const char* end) {
+        std::uint64_t value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            if (cursor == end) {
+                throw std::runtime_error("Unexpected end of file");
+            }
+            auto byte = static_cast<std::uint8_t>(*cursor++);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Varint is too long");
+    }
+
+    // Zigzag encoding keeps small negative numbers small once written as varints
+    inline void write_signed_varint(std::ostream& out, std::int64_t value) {
+        write_varint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    inline std::int64_t read_signed_varint(const char*& cursor, const char* end) {
+        auto value = read_varint(cursor, end);
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+}
@@ -1,9 +1,9 @@
 #pragma once
 
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 #include <optional>
-#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -16,81 +16,99 @@ namespace Toolkit {
 
         // Triggers async loading and returns empty if not already loaded
         std::optional<Value> async_get(const Key& key) {
-            if (not has(key)) {
-                if (not is_loading(key)) {
-                    async_load(key);
+            {
+                std::lock_guard lock{m_mutex};
+                if (auto it = m_mapping.find(key); it != m_mapping.end()) {
+                    return it->second;
+                }
+                if (m_is_loading.count(key) != 0) {
+                    return {};
                 }
-                return {};
-            } else {
-                return get(key);
             }
+            async_load(key);
+            return {};
         }
 
         // Does not trigger loading
         std::optional<Value> get(const Key& key)  {
-            std::shared_lock lock{m_mapping_mutex};
-            if (has(key)) {
-                return m_mapping.at(key);
+            std::lock_guard lock{m_mutex};
+            if (auto it = m_mapping.find(key); it != m_mapping.end()) {
+                return it->second;
             } else {
                 return {};
             }
         }
 
-        // Blocks until loaded
+        // Blocks until loaded, loads in the calling thread if nobody else is
         Value blocking_get(const Key& key) {
-            std::shared_lock lock{m_mapping_mutex};
             load(key);
-            while (is_loading(key)) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::unique_lock lock{m_mutex};
+            m_loaded.wait(lock, [&](){return m_is_loading.count(key) == 0;});
+            if (auto it = m_mapping.find(key); it != m_mapping.end()) {
+                return it->second;
             }
-            return m_mapping.at(key);
+            // the loader we waited on failed, let the error through
+            lock.unlock();
+            return load_resource(key);
         }
 
+        // The lock is never held while the resource loads, so other keys
+        // (and waiters on this one) are not held up by a slow load
         void load(const Key& key) {
-            if (has(key) or is_loading(key)) {
-                return;
-            }
             {
-                std::unique_lock lock{m_is_loading_mutex};
+                std::lock_guard lock{m_mutex};
+                if (m_mapping.count(key) != 0 or m_is_loading.count(key) != 0) {
+                    return;
+                }
                 m_is_loading.insert(key);
             }
-            Value resource = load_resource(key);
-            {
-                std::unique_lock<std::shared_mutex> lock_mapping{m_mapping_mutex, std::defer_lock};
-                std::unique_lock<std::shared_mutex> lock_is_loading{m_is_loading_mutex, std::defer_lock};
-                std::lock(lock_mapping, lock_is_loading);
+            try {
+                Value resource = load_resource(key);
+                std::lock_guard lock{m_mutex};
                 m_mapping.emplace(key, resource);
                 m_is_loading.erase(key);
+            } catch (...) {
+                {
+                    std::lock_guard lock{m_mutex};
+                    m_is_loading.erase(key);
+                }
+                m_loaded.notify_all();
+                throw;
             }
+            m_loaded.notify_all();
         }
         
         void async_load(const Key& key) {
-            std::thread t(&Cache::load, this, key);
+            std::thread t([this, key](){
+                try {
+                    load(key);
+                } catch (...) {
+                    // async_get will try again next time
+                }
+            });
             t.detach();
         }
 
         bool has(const Key& key) {
-            std::shared_lock lock{m_mapping_mutex};
+            std::lock_guard lock{m_mutex};
             return m_mapping.find(key) != m_mapping.end();
         }
 
         bool is_loading(const Key& key) {
-            std::shared_lock lock{m_is_loading_mutex};
+            std::lock_guard lock{m_mutex};
             return m_is_loading.find(key) != m_is_loading.end();
         }
 
         void reserve(const std::size_t& n) {
-            std::unique_lock<std::shared_mutex> lock_mapping{m_mapping_mutex, std::defer_lock};
-            std::unique_lock<std::shared_mutex> lock_is_loading{m_is_loading_mutex, std::defer_lock};
-            std::lock(lock_mapping, lock_is_loading);
+            std::lock_guard lock{m_mutex};
             m_mapping.reserve(n);
             m_is_loading.reserve(n);
         }
 
     private:
         std::unordered_map<Key, Value> m_mapping;
-        std::shared_mutex m_mapping_mutex;
         std::unordered_set<Key> m_is_loading;
-        std::shared_mutex m_is_loading_mutex;
+        std::mutex m_mutex;
+        std::condition_variable m_loaded;
     };
 }
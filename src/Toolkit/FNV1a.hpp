@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Toolkit {
+    // 64 bit FNV-1a hash, unlike std::hash it gives the same result everywhere,
+    // which makes it usable for things written to disk
+    constexpr std::uint64_t fnv1a_64(std::string_view bytes, std::uint64_t hash = 0xcbf29ce484222325ULL) {
+        for (auto byte : bytes) {
+            hash ^= static_cast<std::uint8_t>(byte);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+}
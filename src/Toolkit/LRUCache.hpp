@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace Toolkit {
+    // Thread-safe cache that keeps at most `capacity` values, forgetting the least recently used first.
+    // When several threads ask for the same missing key at once, only the first one calls the loader,
+    // the others wait for its result instead of loading it again
+    template<class Key, class Value, class Hash = std::hash<Key>>
+    class LRUCache {
+    public:
+        explicit LRUCache(std::size_t t_capacity) : capacity(t_capacity) {};
+
+        template<class Loader>
+        Value get_or_load(const Key& key, Loader load) {
+            std::unique_lock lock{mutex};
+            auto it = entries.find(key);
+            if (it != entries.end()) {
+                recently_used.splice(recently_used.begin(), recently_used, it->second.position);
+                auto value = it->second.value;
+                lock.unlock();
+                return value.get();
+            }
+            std::promise<Value> promise;
+            std::shared_future<Value> value = promise.get_future().share();
+            const auto id = next_id++;
+            recently_used.push_front(key);
+            entries.emplace(key, Entry{value, recently_used.begin(), id});
+            // Evicting a value still being loaded is fine, whoever waits on it holds its own copy of the future
+            while (entries.size() > capacity) {
+                entries.erase(recently_used.back());
+                recently_used.pop_back();
+            }
+            lock.unlock();
+            try {
+                promise.set_value(load());
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+                // Don't remember failures, the next call will try again
+                lock.lock();
+                auto failed = entries.find(key);
+                if (failed != entries.end() and failed->second.id == id) {
+                    recently_used.erase(failed->second.position);
+                    entries.erase(failed);
+                }
+            }
+            return value.get();
+        }
+
+        void clear() {
+            std::lock_guard lock{mutex};
+            entries.clear();
+            recently_used.clear();
+        }
+
+    private:
+        struct Entry {
+            std::shared_future<Value> value;
+            typename std::list<Key>::iterator position;
+            // tells apart successive loads of the same key
+            std::size_t id;
+        };
+
+        const std::size_t capacity;
+        std::size_t next_id = 0;
+        std::mutex mutex;
+        // front is the most recently used
+        std::list<Key> recently_used;
+        std::unordered_map<Key, Entry, Hash> entries;
+    };
+}
@@ -0,0 +1,57 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define JUJUBE_HAS_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Toolkit {
+    MappedFile::MappedFile(const fs::path& path) {
+        #ifdef JUJUBE_HAS_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1) {
+                throw std::runtime_error("Could not open "+path.string());
+            }
+            struct stat file_info;
+            if (::fstat(fd, &file_info) == -1) {
+                ::close(fd);
+                throw std::runtime_error("Could not stat "+path.string());
+            }
+            m_size = static_cast<std::size_t>(file_info.st_size);
+            // mmap does not like empty files
+            if (m_size > 0) {
+                void* address = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED) {
+                    m_data = static_cast<const char*>(address);
+                    m_mapped = true;
+                }
+            }
+            ::close(fd);
+            if (m_mapped or m_size == 0) {
+                return;
+            }
+        #endif
+        std::ifstream file{path, std::ios::binary};
+        if (not file) {
+            throw std::runtime_error("Could not open "+path.string());
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+
+    MappedFile::~MappedFile() {
+        #ifdef JUJUBE_HAS_MMAP
+            if (m_mapped) {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+        #endif
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <ghc/filesystem.hpp>
+
+namespace fs = ghc::filesystem;
+
+namespace Toolkit {
+    // Read-only view of a whole file's contents
+    // On unix the file is memory-mapped, elsewhere it's read into memory in one go
+    class MappedFile {
+    public:
+        // Throws std::runtime_error if the file can't be opened
+        explicit MappedFile(const fs::path& path);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const {return m_data;};
+        std::size_t size() const {return m_size;};
+    private:
+        const char* m_data = nullptr;
+        std::size_t m_size = 0;
+        bool m_mapped = false;
+        std::vector<char> m_buffer;
+    };
+}
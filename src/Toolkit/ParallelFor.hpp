@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Toolkit {
+    // Number of threads worth spawning for cpu-bound work, never less than one
+    inline std::size_t worker_count() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Calls func(i) for every i in [0, count) from worker_count() threads,
+    // each thread grabs the next index as soon as it's done with the previous one,
+    // so uneven workloads still keep every core busy.
+    // The first exception thrown by func is rethrown in the calling thread once every worker is done
+    template<typename Func>
+    void parallel_for(std::size_t count, Func func) {
+        std::atomic<std::size_t> next_index = 0;
+        std::exception_ptr first_error;
+        std::mutex error_mutex;
+        auto work = [&](){
+            for (auto i = next_index++; i < count; i = next_index++) {
+                try {
+                    func(i);
+                } catch (...) {
+                    std::lock_guard lock{error_mutex};
+                    if (not first_error) {
+                        first_error = std::current_exception();
+                    }
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        auto thread_count = std::min(worker_count(), count);
+        for (std::size_t t = 1; t < thread_count; t++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (first_error) {
+            std::rethrow_exception(first_error);
+        }
+    }
+}
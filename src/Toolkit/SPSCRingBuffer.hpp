@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+namespace Toolkit {
+    // Bounded queue for exactly one thread pushing and one thread popping
+    // Neither side ever waits on the other, push fails instead when the buffer is full
+    template<typename T, std::size_t Capacity>
+    class SPSCRingBuffer {
+        static_assert(Capacity > 0 and (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "SPSCRingBuffer only holds trivially copyable types");
+    public:
+        // Producer side, returns false if the buffer is full
+        bool push(const T& value) {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            if (head - m_tail.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+            m_buffer[head & (Capacity - 1)] = value;
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        std::optional<T> pop() {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire)) {
+                return {};
+            }
+            T value = m_buffer[tail & (Capacity - 1)];
+            m_tail.store(tail + 1, std::memory_order_release);
+            return value;
+        }
+    private:
+        std::array<T, Capacity> m_buffer;
+        // Both counters only ever grow, kept on separate cache lines so the two threads don't fight over one
+        alignas(64) std::atomic<std::size_t> m_head = 0;
+        alignas(64) std::atomic<std::size_t> m_tail = 0;
+    };
+}
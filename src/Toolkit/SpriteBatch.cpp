@@ -0,0 +1,71 @@
+#include "SpriteBatch.hpp"
+
+namespace Toolkit {
+    void SpriteBatch::clear() {
+        for (std::size_t i = 0; i < m_used_batches; i++) {
+            m_batches[i].second.clear();
+        }
+        m_used_batches = 0;
+        m_sprite_count = 0;
+    }
+
+    void SpriteBatch::add(const sf::Sprite& sprite) {
+        const auto* texture = sprite.getTexture();
+        if (texture == nullptr) {
+            return;
+        }
+        std::size_t index = 0;
+        while (index < m_used_batches and m_batches[index].first != texture) {
+            index++;
+        }
+        if (index == m_used_batches) {
+            if (m_used_batches == m_batches.size()) {
+                m_batches.emplace_back(texture, sf::VertexArray{sf::Triangles});
+            } else {
+                m_batches[m_used_batches].first = texture;
+            }
+            m_used_batches++;
+        }
+        auto& vertices = m_batches[index].second;
+        const auto& transform = sprite.getTransform();
+        const auto bounds = sprite.getLocalBounds();
+        const auto rect = sprite.getTextureRect();
+        const auto color = sprite.getColor();
+        const float left = static_cast<float>(rect.left);
+        const float top = static_cast<float>(rect.top);
+        const float right = left + static_cast<float>(rect.width);
+        const float bottom = top + static_cast<float>(rect.height);
+        const sf::Vertex top_left{transform.transformPoint(0.f, 0.f), color, {left, top}};
+        const sf::Vertex top_right{transform.transformPoint(bounds.width, 0.f), color, {right, top}};
+        const sf::Vertex bottom_right{transform.transformPoint(bounds.width, bounds.height), color, {right, bottom}};
+        const sf::Vertex bottom_left{transform.transformPoint(0.f, bounds.height), color, {left, bottom}};
+        vertices.append(top_left);
+        vertices.append(top_right);
+        vertices.append(bottom_right);
+        vertices.append(top_left);
+        vertices.append(bottom_right);
+        vertices.append(bottom_left);
+        m_sprite_count++;
+    }
+
+    std::size_t SpriteBatch::get_draw_call_count() const {
+        return m_used_batches;
+    }
+
+    void SpriteBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+        for (std::size_t i = 0; i < m_used_batches; i++) {
+            states.texture = m_batches[i].first;
+            target.draw(m_batches[i].second, states);
+        }
+    }
+
+    void SpriteBatch::draw_one_by_one(sf::RenderTarget& target, sf::RenderStates states) const {
+        for (std::size_t i = 0; i < m_used_batches; i++) {
+            states.texture = m_batches[i].first;
+            const auto& vertices = m_batches[i].second;
+            for (std::size_t v = 0; v + 6 <= vertices.getVertexCount(); v += 6) {
+                target.draw(&vertices[v], 6, sf::Triangles, states);
+            }
+        }
+    }
+}
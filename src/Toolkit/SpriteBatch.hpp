@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+namespace Toolkit {
+    // Collects sprites as textured triangles and draws them with one draw call per texture.
+    // Sprites sharing a texture keep the order they were added in, textures are drawn
+    // in the order they were first used, so sprites from different textures may stack differently
+    // than if they were drawn one by one.
+    // Vertex storage is kept between frames, clear() does not free it
+    class SpriteBatch : public sf::Drawable {
+    public:
+        void clear();
+        void add(const sf::Sprite& sprite);
+        // Same result as drawing the batch but with one draw call per sprite, to compare against
+        void draw_one_by_one(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) const;
+        // Draw calls issued by the last draw()
+        std::size_t get_draw_call_count() const;
+        std::size_t get_sprite_count() const {return m_sprite_count;};
+    private:
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+        std::vector<std::pair<const sf::Texture*, sf::VertexArray>> m_batches;
+        // number of entries of m_batches in use this frame
+        std::size_t m_used_batches = 0;
+        std::size_t m_sprite_count = 0;
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace Toolkit {
+    // Hands the latest version of some state from one writer thread to one reader thread
+    // without either of them ever waiting : the writer fills its own buffer then swaps it
+    // with the middle one, the reader swaps the middle one with its own when it's fresh.
+    // Buffers are reused, so containers in T keep their capacity between publications
+    template<typename T>
+    class TripleBuffer {
+    public:
+        // Writer side
+        T& write_buffer() {return m_buffers[m_write];};
+        void publish() {
+            m_write = m_middle.exchange(m_write | fresh_bit, std::memory_order_acq_rel) & index_mask;
+        };
+
+        // Reader side, returns true if a newer version was published since the last call
+        bool update() {
+            if ((m_middle.load(std::memory_order_relaxed) & fresh_bit) == 0) {
+                return false;
+            }
+            m_read = m_middle.exchange(m_read, std::memory_order_acq_rel) & index_mask;
+            return true;
+        };
+        const T& read_buffer() const {return m_buffers[m_read];};
+    private:
+        static constexpr std::size_t fresh_bit = 4;
+        static constexpr std::size_t index_mask = 3;
+        std::array<T, 3> m_buffers;
+        std::size_t m_write = 0;
+        std::atomic<std::size_t> m_middle = 1;
+        std::size_t m_read = 2;
+    };
+}
@@ -0,0 +1,343 @@
+// CPU benchmarks comparing the current code with what it replaced,
+// the old versions are kept here in a minimal form so both run on the same data
+//
+// benchmarks.out [scan|chart|judge]
+//     scan  : reading the metadata of generated .memon files, streaming vs full parse
+//     chart : building a chart, counting scoring events, time bounds and
+//             finding the visible notes every frame, flat arrays vs std::set
+//     judge : playing a dense chart, per-button lanes vs scanning every visible note
+//     runs everything when no argument is given
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ghc/filesystem.hpp>
+#include <memon/memon.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "../src/Data/Chart.hpp"
+#include "../src/Data/GradedNote.hpp"
+#include "../src/Data/MemonMetadata.hpp"
+#include "../src/Data/Score.hpp"
+#include "../src/Screens/Gameplay/Simulation.hpp"
+
+namespace fs = ghc::filesystem;
+
+// Every allocation goes through here so the scan benchmark can tell how much memory a parse needs at most
+namespace {
+    std::size_t allocated_bytes = 0;
+    std::size_t peak_allocated_bytes = 0;
+    // keeps the size in front of each block, big enough to keep the alignment new guarantees
+    constexpr std::size_t header_size = alignof(std::max_align_t);
+}
+
+void* operator new(std::size_t size) {
+    auto block = static_cast<char*>(std::malloc(size + header_size));
+    if (not block) {
+        throw std::bad_alloc{};
+    }
+    *reinterpret_cast<std::size_t*>(block) = size;
+    allocated_bytes += size;
+    peak_allocated_bytes = std::max(peak_allocated_bytes, allocated_bytes);
+    return block + header_size;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer) noexcept {
+    if (not pointer) {
+        return;
+    }
+    auto block = static_cast<char*>(pointer) - header_size;
+    allocated_bytes -= *reinterpret_cast<std::size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+    // Runs the function the given number of times and returns the mean time per run in microseconds
+    double mean_us(std::size_t runs, const std::function<void()>& function) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < runs; i++) {
+            function();
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / static_cast<double>(runs);
+    }
+
+    // Prevents the compiler from dropping a result nobody looks at
+    volatile std::size_t sink = 0;
+
+    void print_comparison(const std::string& what, double old_time, double new_time, const std::string& unit = "us") {
+        std::cout << "    " << what << " : " << old_time << unit << " before, " << new_time << unit << " now";
+        std::cout << " (x" << old_time / new_time << ")" << '\n';
+    }
+
+    // A note on every button in turn every step, every 8th one is a long note
+    std::vector<Data::Note> generated_notes(std::size_t note_count, sf::Time step) {
+        std::vector<Data::Note> notes;
+        notes.reserve(note_count);
+        for (std::size_t i = 0; i < note_count; i++) {
+            auto button = static_cast<Input::Button>(i % 16);
+            auto duration = (i % 8 == 0) ? sf::milliseconds(500) : sf::Time::Zero;
+            notes.push_back({sf::seconds(1) + step * static_cast<float>(i), button, duration, button});
+        }
+        return notes;
+    }
+
+    void write_memon(const fs::path& path, std::size_t notes_per_chart) {
+        std::ofstream file{path};
+        file << R"({"version":"0.2.0","metadata":{"song title":"Benchmark","artist":"jujube",)";
+        file << R"("music path":"song.ogg","album cover path":"jacket.png","BPM":180,"offset":0,)";
+        file << R"("preview":{"position":30,"duration":15}},"data":{)";
+        const std::string difficulties[] = {"BSC", "ADV", "EXT"};
+        for (std::size_t d = 0; d < 3; d++) {
+            file << (d == 0 ? "" : ",") << '"' << difficulties[d] << R"(":{"level":)" << 3 + 3 * d;
+            file << R"(,"resolution":240,"notes":[)";
+            for (std::size_t n = 0; n < notes_per_chart; n++) {
+                file << (n == 0 ? "" : ",") << R"({"n":)" << n % 16 << R"(,"t":)" << 120 * n;
+                file << R"(,"l":)" << (n % 8 == 0 ? 240 : 0) << R"(,"p":)" << (n % 8 == 0 ? 1 : 0) << "}";
+            }
+            file << "]}";
+        }
+        file << "}}";
+    }
+
+    // What MemonSong did for every file before the streaming parser
+    std::size_t read_with_full_parse(const fs::path& path) {
+        stepland::memon memon;
+        std::ifstream file{path};
+        file >> memon;
+        return memon.song_title.size() + memon.charts.size();
+    }
+
+    std::size_t read_with_streaming_parse(const fs::path& path) {
+        auto metadata = Data::read_memon_metadata(path);
+        return metadata.song_title.size() + metadata.chart_levels.size();
+    }
+
+    void run_scan_benchmark() {
+        const std::size_t file_count = 50;
+        const std::size_t notes_per_chart = 2000;
+        const auto folder = fs::temp_directory_path()/"jujube-scan-benchmark";
+        fs::create_directories(folder);
+        std::vector<fs::path> paths;
+        for (std::size_t i = 0; i < file_count; i++) {
+            paths.push_back(folder/(std::to_string(i) + ".memon"));
+            write_memon(paths.back(), notes_per_chart);
+        }
+        std::cout << "scan : " << file_count << " files with 3 charts of " << notes_per_chart << " notes ";
+        std::cout << "(" << fs::file_size(paths.front()) / 1024 << " KiB each)" << '\n';
+
+        auto peak_bytes = [&](std::size_t (*read)(const fs::path&)) {
+            peak_allocated_bytes = allocated_bytes;
+            const auto before = allocated_bytes;
+            sink = read(paths.front());
+            return peak_allocated_bytes - before;
+        };
+        auto old_peak = peak_bytes(&read_with_full_parse);
+        auto new_peak = peak_bytes(&read_with_streaming_parse);
+        auto old_us = mean_us(3, [&](){for (const auto& path : paths) {sink = read_with_full_parse(path);}});
+        auto new_us = mean_us(3, [&](){for (const auto& path : paths) {sink = read_with_streaming_parse(path);}});
+        print_comparison("reading every file", old_us, new_us);
+        std::cout << "    peak memory for one file : " << old_peak / 1024 << " KiB before, ";
+        std::cout << new_peak / 1024 << " KiB now" << '\n';
+        fs::remove_all(folder);
+    }
+
+    // The std::set based layout Data::Chart used to have
+    namespace old_layout {
+        std::size_t count_classic_scoring_events(const std::set<Data::Note>& notes) {
+            std::size_t count = 0;
+            for (auto&& note : notes) {
+                count += note.duration > sf::Time::Zero ? 2 : 1;
+            }
+            return count;
+        }
+
+        sf::Time last_timing_point(const std::set<Data::Note>& notes) {
+            const auto& last_note = *std::max_element(
+                notes.begin(),
+                notes.end(),
+                [](const Data::Note& a, const Data::Note& b) {
+                    return a.timing + a.duration < b.timing + b.duration;
+                }
+            );
+            return last_note.timing + last_note.duration;
+        }
+
+        // Gameplay::Screen's visible notes search, one frame
+        void add_new_visible_notes(
+            std::deque<Data::GradedNote>& notes,
+            std::deque<std::reference_wrapper<Data::GradedNote>>& visible_notes,
+            const sf::Time& music_time
+        ) {
+            Data::GradedNote lower_note, upper_note;
+            if (visible_notes.empty()) {
+                lower_note.position = Input::Button::B16;
+                lower_note.timing = music_time - sf::seconds(16.f/30.f);
+            } else {
+                lower_note = visible_notes.back();
+            }
+            upper_note.position = Input::Button::B1;
+            upper_note.timing = music_time + sf::seconds(16.f/30.f);
+            auto new_notes_begin = std::upper_bound(notes.begin(), notes.end(), lower_note);
+            auto new_notes_end = std::upper_bound(new_notes_begin, notes.end(), upper_note);
+            for (auto it = new_notes_begin; it != new_notes_end; ++it) {
+                visible_notes.emplace_back(*it);
+            }
+        }
+    }
+
+    void run_chart_benchmark() {
+        const std::size_t note_count = 5000;
+        const auto notes = generated_notes(note_count, sf::milliseconds(25));
+        std::cout << "chart : " << note_count << " notes" << '\n';
+
+        auto old_build = mean_us(50, [&](){
+            std::set<Data::Note> set{notes.begin(), notes.end()};
+            sink = set.size();
+        });
+        auto new_build = mean_us(50, [&](){
+            Data::Chart chart{10, notes, 240};
+            sink = chart.notes.size();
+        });
+        print_comparison("building the chart", old_build, new_build);
+
+        const std::set<Data::Note> old_notes{notes.begin(), notes.end()};
+        const Data::Chart chart{10, notes, 240};
+        print_comparison(
+            "count_classic_scoring_events",
+            mean_us(1000, [&](){sink = old_layout::count_classic_scoring_events(old_notes);}),
+            mean_us(1000, [&](){sink = Data::count_classic_scoring_events(chart.notes);})
+        );
+        print_comparison(
+            "get_time_bounds_from_notes",
+            mean_us(1000, [&](){sink = static_cast<std::size_t>(old_layout::last_timing_point(old_notes).asMicroseconds());}),
+            mean_us(1000, [&](){sink = static_cast<std::size_t>(chart.get_time_bounds_from_notes().end.asMicroseconds());})
+        );
+
+        // Every frame of a play at 60 fps, notes leave the visible range once they are 16/30 s old
+        const auto end = chart.get_last_event_timing() + sf::seconds(1);
+        const auto frame = sf::seconds(1.f/60.f);
+        auto old_windowing = mean_us(5, [&](){
+            std::deque<Data::GradedNote> graded{old_notes.begin(), old_notes.end()};
+            std::deque<std::reference_wrapper<Data::GradedNote>> visible_notes;
+            for (auto time = sf::Time::Zero; time < end; time += frame) {
+                while (not visible_notes.empty() and visible_notes.front().get().timing < time - sf::seconds(16.f/30.f)) {
+                    visible_notes.pop_front();
+                }
+                old_layout::add_new_visible_notes(graded, visible_notes, time);
+                sink = visible_notes.size();
+            }
+        });
+        auto new_windowing = mean_us(5, [&](){
+            std::size_t visible_begin = 0;
+            std::size_t visible_end = 0;
+            for (auto time = sf::Time::Zero; time < end; time += frame) {
+                visible_begin = std::max(visible_begin, chart.notes.upper_bound(time - sf::seconds(16.f/30.f)));
+                visible_end = std::max(visible_end, chart.notes.upper_bound(time + sf::seconds(16.f/30.f)));
+                sink = visible_end - visible_begin;
+            }
+        });
+        print_comparison("visible notes for a whole play", old_windowing, new_windowing);
+    }
+
+    std::vector<Gameplay::TimedButtonEvent> perfect_play(const Data::Chart& chart) {
+        std::vector<Gameplay::TimedButtonEvent> events;
+        for (const auto& note : chart.notes) {
+            events.push_back({note.timing, {note.position, Input::EventType::Pressed}});
+            events.push_back({note.timing + note.duration, {note.position, Input::EventType::Released}});
+        }
+        std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b){return a.time < b.time;});
+        return events;
+    }
+
+    // Judging as Gameplay::Screen did before the lanes : every press and release
+    // looks through the visible notes for the first one on its button
+    std::size_t play_with_visible_note_scan(const Data::Chart& chart, const std::vector<Gameplay::TimedButtonEvent>& events) {
+        std::vector<Data::GradedNote> notes{chart.notes.begin(), chart.notes.end()};
+        Data::ClassicScore score{chart.notes};
+        std::size_t visible_begin = 0;
+        std::size_t visible_end = 0;
+        std::size_t combo = 0;
+        for (const auto& [time, event] : events) {
+            visible_begin = std::max(visible_begin, chart.notes.upper_bound(time - sf::seconds(16.f/30.f)));
+            visible_end = std::max(visible_end, chart.notes.upper_bound(time + sf::seconds(16.f/30.f)));
+            for (auto i = visible_begin; i < visible_end; i++) {
+                auto& note = notes[i];
+                if (note.position != event.button) {
+                    continue;
+                }
+                if (event.type == Input::EventType::Pressed) {
+                    if (note.tap_judgement) {
+                        continue;
+                    }
+                    note = Data::GradedNote{note, time - note.timing};
+                    score.update(note.tap_judgement->judgement);
+                } else {
+                    if (note.duration == sf::Time::Zero or not note.tap_judgement or note.long_release) {
+                        continue;
+                    }
+                    note.long_release = Data::TimedJudgement{time - note.timing - note.duration};
+                    score.update(note.long_release->judgement);
+                }
+                combo++;
+                break;
+            }
+        }
+        return combo;
+    }
+
+    void run_judge_benchmark() {
+        // 16 notes every 100ms : over 300 notes on screen at once
+        const Data::Chart chart{10, generated_notes(16 * 600, sf::milliseconds(100) / 16.f), 240};
+        const auto events = perfect_play(chart);
+        std::cout << "judge : " << chart.notes.size() << " notes, " << events.size() << " button events" << '\n';
+        auto old_us = mean_us(5, [&](){sink = play_with_visible_note_scan(chart, events);});
+        auto new_us = mean_us(5, [&](){
+            Gameplay::Simulation sim{chart};
+            sim.play(events);
+            sink = sim.get_combo();
+        });
+        print_comparison("one play", old_us, new_us);
+        const auto event_count = static_cast<double>(events.size());
+        print_comparison("per button event", 1000 * old_us / event_count, 1000 * new_us / event_count, "ns");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::string which = argc > 1 ? argv[1] : "";
+    if (which.empty() or which == "scan") {
+        run_scan_benchmark();
+    }
+    if (which.empty() or which == "chart") {
+        run_chart_benchmark();
+    }
+    if (which.empty() or which == "judge") {
+        run_judge_benchmark();
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+// Hammers Toolkit::Cache from several threads at once, blocking_get used
+// to hold its lock while loading and while waiting on other loaders
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/Toolkit/Cache.hpp"
+
+namespace {
+    std::atomic<int> load_count = 0;
+
+    int slow_square(const int& key) {
+        load_count++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return key * key;
+    }
+
+    using SquareCache = Toolkit::Cache<int, int, &slow_square>;
+
+    int failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (not condition) {
+            std::cerr << "FAILED : " << what << '\n';
+            failures++;
+        }
+    }
+}
+
+int main() {
+    // a deadlock shows up as a future that never becomes ready
+    const auto deadline = std::chrono::seconds(10);
+    SquareCache cache;
+    std::vector<std::future<int>> results;
+    for (int round = 0; round < 4; round++) {
+        for (int key = 0; key < 8; key++) {
+            results.push_back(std::async(std::launch::async, [&cache, key](){return cache.blocking_get(key);}));
+            results.push_back(std::async(std::launch::async, [&cache, key](){cache.load(key); return key * key;}));
+            cache.async_get(key);
+        }
+    }
+    bool all_ready = true;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        if (results[i].wait_for(deadline) != std::future_status::ready) {
+            all_ready = false;
+            break;
+        }
+        check(results[i].get() == static_cast<int>((i / 2) % 8) * static_cast<int>((i / 2) % 8), "blocking_get returns the loaded value");
+    }
+    if (not all_ready) {
+        std::cerr << "FAILED : blocking_get and load finish when called together\n";
+        // the stuck threads would keep the process alive
+        std::quick_exit(1);
+    }
+    check(load_count == 8, "each key is loaded once");
+    for (int key = 0; key < 8; key++) {
+        check(cache.get(key) == key * key, "get sees what blocking_get loaded");
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Cache : all checks passed\n";
+    return 0;
+}
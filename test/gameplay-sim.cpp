@@ -0,0 +1,152 @@
+// Runs charts through Gameplay::Simulation without opening a window or playing any audio
+//
+// gameplay_sim.out
+//     checks the grading of generated charts against known results
+// gameplay_sim.out <file.memon> <difficulty> [plays] [max error in ms]
+//     plays the chart again and again with random timing errors,
+//     prints how many plays per second were simulated and the score spread
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <memon/memon.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "../src/Data/Chart.hpp"
+#include "../src/Screens/Gameplay/Simulation.hpp"
+
+namespace {
+    // Presses every note at its timing plus an error picked by get_error,
+    // long notes are released at their end plus another error
+    template<class ErrorGenerator>
+    std::vector<Gameplay::TimedButtonEvent> play_with_errors(const Data::Chart& chart, ErrorGenerator get_error) {
+        std::vector<Gameplay::TimedButtonEvent> events;
+        events.reserve(chart.notes.size() * 2);
+        for (const auto& note : chart.notes) {
+            events.push_back({note.timing + get_error(), {note.position, Input::EventType::Pressed}});
+            events.push_back({note.timing + note.duration + get_error(), {note.position, Input::EventType::Released}});
+        }
+        std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b){return a.time < b.time;});
+        return events;
+    }
+
+    // A note every 100ms cycling through the buttons, every 10th one is a 300ms long note
+    Data::Chart generated_chart(std::size_t note_count) {
+        std::vector<Data::Note> notes;
+        for (std::size_t i = 0; i < note_count; i++) {
+            auto button = static_cast<Input::Button>(i % 16);
+            auto duration = (i % 10 == 0) ? sf::milliseconds(300) : sf::Time::Zero;
+            notes.push_back({sf::milliseconds(1000 + 100 * static_cast<int>(i)), button, duration, button});
+        }
+        return Data::Chart{10, notes, 240};
+    }
+
+    int failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (not condition) {
+            std::cerr << "FAILED : " << what << '\n';
+            failures++;
+        }
+    }
+
+    void run_checks() {
+        const auto chart = generated_chart(1000);
+        const auto scoring_events = Data::count_classic_scoring_events(chart.notes);
+        {
+            Gameplay::Simulation sim{chart};
+            sim.play(play_with_errors(chart, [](){return sf::Time::Zero;}));
+            check(sim.get_score().get_final_score() == 1000000, "perfect play scores 1 000 000");
+            check(sim.get_score().get_rating() == Data::Rating::EXC, "perfect play is rated EXC");
+            check(sim.get_combo() == scoring_events, "perfect play combo counts every tap and release");
+            check(sim.get_density_graph_grade_count() == scoring_events, "every scoring event reaches the density graph");
+        }
+        {
+            Gameplay::Simulation sim{chart};
+            sim.play({});
+            check(sim.get_score().get_final_score() == 0, "no input scores 0");
+            check(sim.get_score().get_judgement_count(Data::Judgement::Miss) == scoring_events, "no input misses everything");
+            check(sim.get_combo() == 0, "no input has no combo");
+        }
+        {
+            Gameplay::Simulation sim{chart};
+            sim.play(play_with_errors(chart, [](){return sf::milliseconds(60);}));
+            check(sim.get_score().get_judgement_count(Data::Judgement::Great) == chart.notes.size(), "taps 60ms late are GREAT");
+            check(sim.get_score().get_judgement_count(Data::Judgement::Miss) == 0, "taps 60ms late never miss");
+        }
+        {
+            // the very first note only comes on screen 16/30 s before its timing
+            Gameplay::Simulation sim{chart};
+            sim.update(sf::Time::Zero);
+            sim.handle_button_event({Input::Button::B1, Input::EventType::Pressed}, sf::Time::Zero);
+            check(sim.get_density_graph_grade_count() == 0, "presses before the note is visible are ignored");
+        }
+        {
+            std::mt19937 first_rng{42};
+            std::mt19937 second_rng{42};
+            std::uniform_int_distribution<int> error_ms{-200, 200};
+            Gameplay::Simulation first{chart};
+            first.play(play_with_errors(chart, [&](){return sf::milliseconds(error_ms(first_rng));}));
+            Gameplay::Simulation second{chart};
+            second.play(play_with_errors(chart, [&](){return sf::milliseconds(error_ms(second_rng));}));
+            bool same_grades = std::equal(
+                first.get_density_graph_grades().begin(),
+                first.get_density_graph_grades().end(),
+                second.get_density_graph_grades().begin()
+            );
+            check(same_grades, "the same inputs always give the same grades");
+            check(first.get_score().get_final_score() == second.get_score().get_final_score(), "the same inputs always give the same score");
+        }
+    }
+
+    void run_benchmark(const Data::Chart& chart, std::size_t plays, int max_error_ms) {
+        std::mt19937 rng{0};
+        std::uniform_int_distribution<int> error_ms{-max_error_ms, max_error_ms};
+        std::vector<std::vector<Gameplay::TimedButtonEvent>> inputs;
+        for (std::size_t i = 0; i < std::min<std::size_t>(plays, 64); i++) {
+            inputs.push_back(play_with_errors(chart, [&](){return sf::milliseconds(error_ms(rng));}));
+        }
+        int min_score = 1000000;
+        int max_score = 0;
+        long long total_score = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < plays; i++) {
+            Gameplay::Simulation sim{chart};
+            sim.play(inputs[i % inputs.size()]);
+            auto score = sim.get_score().get_final_score();
+            min_score = std::min(min_score, score);
+            max_score = std::max(max_score, score);
+            total_score += score;
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << chart.notes.size() << " notes, " << plays << " plays in " << elapsed << "s";
+        std::cout << " (" << static_cast<double>(plays) / elapsed << " plays/s)" << '\n';
+        std::cout << "score min " << min_score << ", mean " << total_score / static_cast<long long>(plays) << ", max " << max_score << '\n';
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        run_checks();
+        run_benchmark(generated_chart(1000), 1000, 100);
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc < 3) {
+        std::cerr << "Usage : " << argv[0] << " [<file.memon> <difficulty> [plays] [max error in ms]]" << '\n';
+        return EXIT_FAILURE;
+    }
+    std::ifstream file{argv[1]};
+    stepland::memon memon;
+    file >> memon;
+    const Data::Chart chart{memon, argv[2]};
+    std::size_t plays = argc > 3 ? std::stoul(argv[3]) : 10000;
+    int max_error_ms = argc > 4 ? std::stoi(argv[4]) : 100;
+    run_benchmark(chart, std::max<std::size_t>(plays, 1), max_error_ms);
+    return EXIT_SUCCESS;
+}